@@ -0,0 +1,175 @@
+/**
+ * sjtu::map and sjtu::btree_map against std::map: inserting random and
+ * ascending keys, finding keys that are present, erasing every key through find, and an
+ * in-order scan. sjtu::flat_map and the frozen_map from map::freeze() only
+ * run the read-only ones. sjtu::unordered_map runs against sjtu::map and
+ * std::unordered_map on everything but the ordered scan.
+ */
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "btree_map.hpp"
+#include "flat_map.hpp"
+#include "map.hpp"
+#include "unordered_map.hpp"
+
+namespace {
+
+std::vector<int> random_keys(long long n, unsigned seed) {
+    std::vector<int> keys(n);
+    for (long long i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+    return keys;
+}
+
+template <typename Map>
+void fill(Map &m, const std::vector<int> &keys) {
+    for (int key : keys) {
+        m.insert(typename Map::value_type(key, key));
+    }
+}
+
+using SjtuFlatMap = sjtu::flat_map<int, int>;
+
+void fill(SjtuFlatMap &m, const std::vector<int> &keys) {
+    std::vector<int> sorted(keys);
+    std::sort(sorted.begin(), sorted.end());
+    SjtuFlatMap::key_container flat_keys;
+    SjtuFlatMap::mapped_container flat_values;
+    flat_keys.reserve(sorted.size());
+    flat_values.reserve(sorted.size());
+    for (int key : sorted) {
+        flat_keys.push_back(key);
+        flat_values.push_back(key);
+    }
+    m = SjtuFlatMap(sjtu::adopt_sorted, std::move(flat_keys), std::move(flat_values));
+}
+
+using SjtuFrozenMap = sjtu::frozen_map<int, int>;
+
+void fill(SjtuFrozenMap &m, const std::vector<int> &keys) {
+    sjtu::map<int, int> tree;
+    fill(tree, keys);
+    m = tree.freeze();
+}
+
+template <typename Map>
+void BM_Insert(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 1);
+    for (auto _ : state) {
+        Map m;
+        fill(m, keys);
+        benchmark::DoNotOptimize(m.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// ascending keys rotate at the right spine on every other insert, which
+// is where map's rebalancing stops early once a height is unchanged
+template <typename Map>
+void BM_InsertAscending(benchmark::State &state) {
+    std::vector<int> keys(state.range(0));
+    for (long long i = 0; i < state.range(0); ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    for (auto _ : state) {
+        Map m;
+        fill(m, keys);
+        benchmark::DoNotOptimize(m.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map>
+void BM_Find(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 2);
+    const auto queries = random_keys(state.range(0), 3);
+    Map m;
+    fill(m, keys);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (int key : queries) {
+            sum += m.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map>
+void BM_Erase(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 4);
+    const auto order = random_keys(state.range(0), 5);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Map m;
+        fill(m, keys);
+        state.ResumeTiming();
+        for (int key : order) {
+            m.erase(m.find(key));
+        }
+        benchmark::DoNotOptimize(m.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Map>
+void BM_Iterate(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 6);
+    Map m;
+    fill(m, keys);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto it = m.begin(); it != m.end(); ++it) {
+            sum += it->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using SjtuMap = sjtu::map<int, int>;
+using SjtuLinkedMap = sjtu::map<int, int, std::less<int>, false, true>;
+using SjtuBtreeMap = sjtu::btree_map<int, int>;
+using StdMap = std::map<int, int>;
+using SjtuUnorderedMap = sjtu::unordered_map<int, int>;
+using StdUnorderedMap = std::unordered_map<int, int>;
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, SjtuMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Insert, SjtuBtreeMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Insert, StdMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Insert, SjtuUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Insert, StdUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_InsertAscending, SjtuMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_InsertAscending, SjtuBtreeMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_InsertAscending, StdMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, SjtuMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, SjtuBtreeMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, SjtuFlatMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, SjtuFrozenMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, StdMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, SjtuUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Find, StdUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Erase, SjtuMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Erase, SjtuBtreeMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Erase, StdMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Erase, SjtuUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Erase, StdUnorderedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuLinkedMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuBtreeMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuFlatMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuFrozenMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+BENCHMARK_TEMPLATE(BM_Iterate, StdMap)->RangeMultiplier(8)->Range(1 << 9, 1 << 18);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,102 @@
+/**
+ * sjtu::priority_queue against std::priority_queue: push, push then pop
+ * everything, and merging two queues of n elements each.
+ *
+ * std::priority_queue has no merge, its baseline pushes the other queue's
+ * elements one by one, which is what a user would have to do.
+ */
+#include <benchmark/benchmark.h>
+
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+namespace {
+
+std::vector<int> random_keys(long long n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<int> keys(n);
+    for (auto &key : keys) {
+        key = static_cast<int>(gen());
+    }
+    return keys;
+}
+
+void merge_into(sjtu::priority_queue<int> &a, sjtu::priority_queue<int> &b) {
+    a.merge(b);
+}
+
+void merge_into(std::priority_queue<int> &a, std::priority_queue<int> &b) {
+    while (!b.empty()) {
+        a.push(b.top());
+        b.pop();
+    }
+}
+
+template <typename Queue>
+void BM_Push(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 1);
+    for (auto _ : state) {
+        Queue q;
+        for (int key : keys) {
+            q.push(key);
+        }
+        benchmark::DoNotOptimize(q.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Queue>
+void BM_PushPop(benchmark::State &state) {
+    const auto keys = random_keys(state.range(0), 2);
+    for (auto _ : state) {
+        Queue q;
+        for (int key : keys) {
+            q.push(key);
+        }
+        long long sum = 0;
+        while (!q.empty()) {
+            sum += q.top();
+            q.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Queue>
+void BM_Merge(benchmark::State &state) {
+    const auto left = random_keys(state.range(0), 3);
+    const auto right = random_keys(state.range(0), 4);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Queue a, b;
+        for (int key : left) {
+            a.push(key);
+        }
+        for (int key : right) {
+            b.push(key);
+        }
+        state.ResumeTiming();
+        merge_into(a, b);
+        benchmark::DoNotOptimize(a.top());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using SjtuQueue = sjtu::priority_queue<int>;
+using StdQueue = std::priority_queue<int>;
+
+}  // namespace
+
+// Kept below 1 << 16: the pairing heap frees its nodes recursively.
+BENCHMARK_TEMPLATE(BM_Push, SjtuQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Push, StdQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PushPop, SjtuQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PushPop, StdQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Merge, SjtuQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Merge, StdQueue)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+BENCHMARK_MAIN();
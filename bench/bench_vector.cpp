@@ -0,0 +1,98 @@
+/**
+ * sjtu::vector against std::vector: push_back, insert and erase in the
+ * middle, and a full scan through iterators.
+ *
+ * The argument is the number of elements, results are in items per second
+ * so the sizes can be compared with each other.
+ */
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "vector.hpp"
+
+namespace {
+
+template <typename Vector>
+void BM_PushBack(benchmark::State &state) {
+    const long long n = state.range(0);
+    for (auto _ : state) {
+        Vector v;
+        for (long long i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// n inserts at the middle of a vector that grows from n to 2n elements
+template <typename Vector>
+void BM_InsertMiddle(benchmark::State &state) {
+    const long long n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Vector v;
+        for (long long i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        state.ResumeTiming();
+        for (long long i = 0; i < n; ++i) {
+            v.insert(v.begin() + v.size() / 2, i);
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// erases the middle element until half of the n elements are gone
+template <typename Vector>
+void BM_EraseMiddle(benchmark::State &state) {
+    const long long n = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Vector v;
+        for (long long i = 0; i < n; ++i) {
+            v.push_back(i);
+        }
+        state.ResumeTiming();
+        for (long long i = 0; i < n / 2; ++i) {
+            v.erase(v.begin() + v.size() / 2);
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.SetItemsProcessed(state.iterations() * (n / 2));
+}
+
+template <typename Vector>
+void BM_Iterate(benchmark::State &state) {
+    const long long n = state.range(0);
+    Vector v;
+    for (long long i = 0; i < n; ++i) {
+        v.push_back(i);
+    }
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto it = v.begin(); it != v.end(); ++it) {
+            sum += *it;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+using SjtuVector = sjtu::vector<long long>;
+using StdVector = std::vector<long long>;
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_PushBack, SjtuVector)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBack, StdVector)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(BM_InsertMiddle, SjtuVector)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_InsertMiddle, StdVector)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseMiddle, SjtuVector)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseMiddle, StdVector)->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+BENCHMARK_TEMPLATE(BM_Iterate, SjtuVector)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Iterate, StdVector)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+BENCHMARK_MAIN();
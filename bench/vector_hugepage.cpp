@@ -0,0 +1,103 @@
+/**
+ * page faults and sequential scan time of sjtu::vector under each map_policy.
+ *
+ * usage: vector_hugepage [elements]   (default 1 << 24 long longs, 128 MiB)
+ *
+ * For every policy the vector is sized with one reserve(), filled with
+ * push_back and scanned twice. Faults and time are reported separately for
+ * the reserve and the fill, so prefaulting shows up where it happens.
+ * Minor faults come from getrusage, huge-page backed memory from
+ * AnonHugePages in /proc/self/smaps_rollup.
+ */
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "vector.hpp"
+
+using namespace std::chrono;
+
+namespace {
+
+long minor_faults() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+// in kB, -1 if the kernel does not report it
+long anon_huge_pages() {
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if (!file) {
+        return -1;
+    }
+    char line[256];
+    long kb = -1;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "AnonHugePages:", 14) == 0) {
+            kb = strtol(line + 14, nullptr, 10);
+            break;
+        }
+    }
+    fclose(file);
+    return kb;
+}
+
+void run(const char *name, sjtu::map_policy policy, size_t n) {
+    sjtu::vector<long long> v(policy);
+
+    long faults = minor_faults();
+    auto start = steady_clock::now();
+    v.reserve(n);
+    auto reserved = steady_clock::now();
+    long reserve_faults = minor_faults() - faults;
+
+    faults = minor_faults();
+    for (size_t i = 0; i < n; ++i) {
+        v.push_back(static_cast<long long>(i));
+    }
+    auto filled = steady_clock::now();
+    long fill_faults = minor_faults() - faults;
+    long huge_kb = anon_huge_pages();
+
+    long long sum = 0;
+    for (int round = 0; round < 2; ++round) {
+        for (sjtu::vector<long long>::const_iterator it = v.cbegin();
+             it != v.cend(); ++it) {
+            sum += *it;
+        }
+    }
+    auto scanned = steady_clock::now();
+
+    printf("%-14s %10ld %10lld %10ld %10lld %10lld %10ld %16lld\n", name,
+           reserve_faults,
+           static_cast<long long>(
+               duration_cast<microseconds>(reserved - start).count()),
+           fill_faults,
+           static_cast<long long>(
+               duration_cast<microseconds>(filled - reserved).count()),
+           static_cast<long long>(
+               duration_cast<microseconds>(scanned - filled).count()),
+           huge_kb, sum);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t n = size_t(1) << 24;
+    if (argc > 1) {
+        n = strtoull(argv[1], nullptr, 10);
+    }
+    printf("%zu elements, %zu MiB\n", n, n * sizeof(long long) >> 20);
+    printf("%-14s %10s %10s %10s %10s %10s %10s %16s\n", "policy", "rsv_flt",
+           "rsv_us", "fill_flt", "fill_us", "scan_us", "huge_kB", "checksum");
+    run("none", sjtu::map_policy::none, n);
+    run("populate", sjtu::map_policy::populate, n);
+    run("huge", sjtu::map_policy::huge_pages, n);
+    run("huge+populate",
+        sjtu::map_policy::huge_pages | sjtu::map_policy::populate, n);
+    return 0;
+}
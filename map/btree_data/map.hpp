@@ -0,0 +1,16 @@
+/**
+ * stands in for map.hpp in the btree_* tests: the same test programs run
+ * with sjtu::map meaning btree_map. Only the ones that keep no iterator
+ * across an insert or erase can, see btree_map.hpp.
+ */
+#ifndef SJTU_BTREE_DATA_MAP_HPP
+#define SJTU_BTREE_DATA_MAP_HPP
+
+#include "btree_map.hpp"
+
+namespace sjtu {
+  template<class Key, class T, class Compare = std::less<Key> >
+  using map = btree_map<Key, T, Compare>;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#include "map.hpp"
+#include <compare>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+
+int constructed = 0;
+
+// a key that counts how often it is built
+struct Name {
+	std::string s;
+	Name(const char *c) : s(c) { ++constructed; }
+	Name(const Name &other) : s(other.s) { ++constructed; }
+	bool operator<(const Name &other) const { return s < other.s; }
+};
+
+struct NameLess {
+	using is_transparent = void;
+	bool operator()(const Name &a, const Name &b) const { return a.s < b.s; }
+	bool operator()(const Name &a, std::string_view b) const { return a.s < b; }
+	bool operator()(std::string_view a, const Name &b) const { return a < b.s; }
+};
+
+void test_no_temporaries() {
+	sjtu::map<Name, int, NameLess> m;
+	const char *names[] = {"route", "user", "order", "item", "cart", "login"};
+	for (int i = 0; i < 6; ++i) {
+		m.insert(sjtu::pair<const Name, int>(Name(names[i]), i));
+	}
+	constructed = 0;
+	int sum = 0;
+	for (int round = 0; round < 1000; ++round) {
+		sum += m.find(std::string_view("order"))->second;
+		sum += (int)m.count(std::string_view("missing"));
+	}
+	const auto &cm = m;
+	printf("%d %d %d\n", sum, cm.find(std::string_view("cart"))->second, constructed);
+	// a Key argument still picks the plain overload
+	int login = m.find(Name("login"))->second;
+	printf("%d %d\n", login, constructed);
+}
+
+void test_standard_comparators() {
+	sjtu::map<std::string, int, std::less<>> m;
+	m["alpha"] = 1;
+	m["beta"] = 2;
+	const char *c = "beta";
+	std::string_view sv = "alpha";
+	printf("%d %d %d\n", m.find(c)->second, m.find(sv)->second, (int)m.count("gamma"));
+
+	sjtu::map<std::string, int, std::compare_three_way> t;
+	t["x"] = 24;
+	printf("%d %d\n", t.find(std::string_view("x"))->second, (int)t.count("y"));
+}
+
+int main() {
+	test_no_temporaries();
+	test_standard_comparators();
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "map.hpp"
+#include <cstdio>
+#include <string>
+
+int alive = 0, copies_left = -1;
+
+// counts the live values and throws from its copy once copies_left runs out
+struct Fragile {
+	std::string val;
+	Fragile(int key, int round) : val(std::to_string(key) + "/" + std::to_string(round)) { ++alive; }
+	Fragile(const Fragile &other) : val(other.val) {
+		if (copies_left == 0) throw sjtu::runtime_error();
+		if (copies_left > 0) --copies_left;
+		++alive;
+	}
+	~Fragile() { --alive; }
+};
+
+const int N = 20000;
+
+unsigned seed = 18;
+
+int next_rand() {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 8) & 0xffff;
+}
+
+// round[k] is the round key k was last inserted in, -1 if it is absent
+template<class Map>
+bool same(const Map &m, const int *round) {
+	size_t expected = 0;
+	for (int k = 0; k < N; ++k) {
+		if (round[k] < 0) continue;
+		++expected;
+		auto it = m.find(k);
+		if (it == m.cend() || it->second.val != Fragile(k, round[k]).val) return false;
+	}
+	int last = -1;
+	size_t walked = 0;
+	for (auto it = m.cbegin(); it != m.cend(); ++it, ++walked) {
+		if (it->first <= last || round[it->first] < 0) return false;
+		last = it->first;
+	}
+	return m.size() == expected && walked == expected;
+}
+
+template<class Map>
+void test_pool(const char *name) {
+	static int round[N];
+	Map m;
+	for (int k = 0; k < N; ++k) {
+		round[k] = 0;
+		m.try_emplace(k, k, 0);
+	}
+	int ok = same(m, round);
+	// freed nodes go back to the pool and are handed out again
+	for (int r = 1; r <= 5; ++r) {
+		for (int i = 0; i < N; ++i) {
+			int k = (next_rand() * 7 + i) % N;
+			if (round[k] >= 0) {
+				m.erase(m.find(k));
+				round[k] = -1;
+			}
+		}
+		for (int k = 0; k < N; k += r + 1) {
+			if (round[k] < 0) {
+				round[k] = r;
+				m.try_emplace(k, k, r);
+			}
+		}
+		ok += same(m, round);
+	}
+	int others = alive - (int)m.size();
+	m.clear();
+	for (int k = 0; k < N; ++k) round[k] = -1;
+	ok += same(m, round) && alive == others && m.begin() == m.end();
+	for (int k = N - 1; k >= 0; k -= 3) {
+		round[k] = 9;
+		m.try_emplace(k, k, 9);
+	}
+	ok += same(m, round);
+	printf("%s: %d %d\n", name, (int)m.size(), ok);
+}
+
+template<class Map>
+void test_throwing_copy(const char *name) {
+	static int round[N];
+	Map m;
+	for (int k = 0; k < N; ++k) {
+		round[k] = k % 3 ? 1 : -1;
+		if (round[k] > 0) m.try_emplace(k, k, 1);
+	}
+	int before = alive, threw = 0;
+	for (int after : {0, 1, 100, (int)m.size() / 2, (int)m.size() - 1}) {
+		copies_left = after;
+		try {
+			Map copy(m);
+		} catch (sjtu::runtime_error &) {
+			++threw;
+		}
+		copies_left = -1;
+	}
+	int ok = alive == before && same(m, round);
+
+	// a failed assignment leaves the target as it was
+	Map target;
+	target.try_emplace(-1, -1, 0);
+	copies_left = (int)m.size() / 3;
+	try {
+		target = m;
+	} catch (sjtu::runtime_error &) {
+		++threw;
+	}
+	copies_left = -1;
+	ok += target.size() == 1 && target.at(-1).val == "-1/0" && alive == before + 1;
+
+	target = m;
+	ok += same(target, round) && alive == 2 * before;
+	target.clear();
+	ok += same(m, round) && alive == before;
+	printf("%s: %d %d\n", name, threw, ok);
+}
+
+int main() {
+	test_pool<sjtu::map<int, Fragile>>("plain");
+	test_pool<sjtu::map<int, Fragile, std::less<int>, true, true>>("ranked linked");
+	test_throwing_copy<sjtu::map<int, Fragile>>("plain");
+	test_throwing_copy<sjtu::map<int, Fragile, std::less<int>, true, true>>("ranked linked");
+	printf("%d\n", alive);
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include "map.hpp"
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+using linked = sjtu::map<int, std::string, std::less<int>, false, true>;
+
+void print(const linked &m) {
+	for (auto it = m.cbegin(); it != m.cend(); ++it) {
+		printf("%d%s ", it->first, it->second.c_str());
+	}
+	printf("| ");
+	auto it = m.cend();
+	while (it != m.cbegin()) {
+		--it;
+		printf("%d ", it->first);
+	}
+	printf("\n");
+}
+
+void test_basic() {
+	linked m;
+	print(m);
+	for (int i = 0; i < 10; ++i) {
+		m[i * 7 % 10] = "";
+	}
+	print(m);
+	// erase the nodes with two children, one child and none
+	m.erase(m.find(3));
+	m.erase(m.begin());
+	m.erase(--m.end());
+	print(m);
+	for (auto it = m.begin(); it != m.end();) {
+		auto next = it;
+		++next;
+		if (it->first % 2 == 0) {
+			m.erase(it);
+		}
+		it = next;
+	}
+	print(m);
+	try {
+		--m.begin();
+	} catch (sjtu::invalid_iterator &) {
+		printf("before begin\n");
+	}
+	try {
+		++m.end();
+	} catch (sjtu::invalid_iterator &) {
+		printf("past end\n");
+	}
+}
+
+void test_copy_and_bulk() {
+	std::vector<sjtu::pair<int, std::string>> v;
+	for (int i = 0; i < 20; i += 2) {
+		v.push_back(sjtu::pair<int, std::string>(i, "a"));
+	}
+	linked m(v.begin(), v.end());
+	v.clear();
+	for (int i = 1; i < 20; i += 4) {
+		v.push_back(sjtu::pair<int, std::string>(i, "b"));
+	}
+	m.insert_sorted(v.begin(), v.end());
+	print(m);
+	linked c(m);
+	c.erase(c.find(0));
+	c[100] = "c";
+	linked d;
+	d[-1] = "d";
+	d = c;
+	print(d);
+	print(m);
+	d.clear();
+	d[5] = "e";
+	print(d);
+}
+
+int main() {
+	test_basic();
+	test_copy_and_bulk();
+	return 0;
+}
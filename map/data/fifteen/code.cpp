@@ -0,0 +1,167 @@
+#include "map.hpp"
+#include "flat_map.hpp"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+typedef sjtu::flat_map<int, std::string> FlatMap;
+
+static_assert(std::is_nothrow_move_constructible_v<FlatMap>);
+static_assert(std::is_nothrow_move_assignable_v<FlatMap>);
+
+unsigned seed = 15;
+
+int next_rand() {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 8) & 0xffff;
+}
+
+void same(const FlatMap &flat, const sjtu::map<int, std::string> &tree) {
+	assert(flat.size() == tree.size());
+	auto it = flat.cbegin();
+	for (auto jt = tree.cbegin(); jt != tree.cend(); ++jt, ++it) {
+		assert(it->first == jt->first && it->second == jt->second);
+	}
+	assert(it == flat.cend());
+}
+
+void test_against_map() {
+	FlatMap flat;
+	sjtu::map<int, std::string> tree;
+	for (int step = 0; step < 30000; ++step) {
+		int key = next_rand() % 3000;
+		int op = next_rand() % 4;
+		if (op < 2) {
+			sjtu::pair<const int, std::string> value(key, std::to_string(key));
+			[[maybe_unused]] bool a = flat.insert(value).second;
+			[[maybe_unused]] bool b = tree.insert(value).second;
+			assert(a == b);
+		} else if (op == 2) {
+			auto it = flat.find(key);
+			assert((it == flat.end()) == (tree.count(key) == 0));
+			if (it != flat.end()) {
+				flat.erase(it);
+				tree.erase(tree.find(key));
+			}
+		} else {
+			auto lb = flat.lower_bound(key);
+			auto ub = flat.upper_bound(key);
+			[[maybe_unused]] auto tlb = tree.lower_bound(key);
+			[[maybe_unused]] auto tub = tree.upper_bound(key);
+			assert((lb == flat.end()) == (tlb == tree.end()));
+			assert((ub == flat.end()) == (tub == tree.end()));
+			if (lb != flat.end()) assert(lb->first == tlb->first);
+			if (ub != flat.end()) assert(ub->first == tub->first);
+			flat[key] += "*";
+			tree[key] += "*";
+		}
+	}
+	same(flat, tree);
+	printf("%d\n", (int)flat.size());
+	auto last = flat.end();
+	--last;
+	printf("%d %s\n", last->first, (*last).second.c_str());
+
+	FlatMap copy(flat);
+	flat.clear();
+	same(copy, tree);
+	printf("%d %d\n", (int)flat.size(), (int)copy.size());
+}
+
+void test_adopt() {
+	sjtu::flat_map<long long, int>::key_container keys;
+	sjtu::flat_map<long long, int>::mapped_container values;
+	for (int i = 0; i < 100000; ++i) {
+		keys.push_back(3LL * i);
+		values.push_back(i);
+	}
+	sjtu::flat_map<long long, int> flat(sjtu::adopt_sorted, std::move(keys), std::move(values));
+	printf("%d\n", (int)flat.size());
+	long long hits = 0, sum = 0;
+	for (long long k = -5; k < 300005; ++k) {
+		hits += flat.count(k);
+		auto it = flat.lower_bound(k);
+		if (it != flat.end()) sum += it->second;
+	}
+	printf("%lld %lld\n", hits, sum);
+
+	long long key_sum = 0;
+	for (size_t i = 0; i < flat.keys().size(); ++i) key_sum += flat.keys()[i];
+	printf("%lld %d\n", key_sum, flat.values()[flat.values().size() - 1]);
+
+	flat.begin()->second = -1;
+	flat.at(3) = -2;
+	printf("%d %d\n", flat[0], flat[3]);
+
+	// moving the map hands the arrays over instead of copying them
+	const long long *adopted = flat.keys().data();
+	sjtu::flat_map<long long, int> moved(std::move(flat));
+	sjtu::flat_map<long long, int> assigned;
+	assigned = std::move(moved);
+	printf("%d %d %d\n", (int)(assigned.keys().data() == adopted), (int)assigned.size(), (int)flat.size());
+
+	FlatMap strings;
+	sjtu::pair<const int, std::string> value(1, std::string(100, 'x'));
+	strings.insert(std::move(value));
+	printf("%d %d %d\n", (int)strings.size(), (int)strings.at(1).size(), (int)value.second.size());
+
+	sjtu::flat_map<int, int>::key_container unsorted_keys, unsorted_values;
+	unsorted_keys.push_back(2);
+	unsorted_keys.push_back(1);
+	unsorted_values.push_back(0);
+	unsorted_values.push_back(0);
+	try {
+		sjtu::flat_map<int, int> bad(sjtu::adopt_sorted, std::move(unsorted_keys), std::move(unsorted_values));
+	} catch (sjtu::runtime_error &) {
+		puts("unsorted: runtime_error");
+	}
+	sjtu::flat_map<int, int>::key_container short_keys, long_values;
+	long_values.push_back(1);
+	try {
+		sjtu::flat_map<int, int> bad(sjtu::adopt_sorted, std::move(short_keys), std::move(long_values));
+	} catch (sjtu::runtime_error &) {
+		puts("sizes: runtime_error");
+	}
+}
+
+void test_exceptions() {
+	FlatMap flat;
+	try {
+		flat.at(1);
+	} catch (sjtu::index_out_of_bound &) {
+		puts("at: index_out_of_bound");
+	}
+	try {
+		--flat.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("--end: invalid_iterator");
+	}
+	try {
+		*flat.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("*end: invalid_iterator");
+	}
+	flat.try_emplace(1, 3, 'x');
+	try {
+		auto it = flat.end();
+		++it;
+	} catch (sjtu::invalid_iterator &) {
+		puts("++end: invalid_iterator");
+	}
+	FlatMap other(flat);
+	try {
+		flat.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		puts("erase other: invalid_iterator");
+	}
+	const FlatMap &view = flat;
+	printf("%s %s %d\n", view.at(1).c_str(), view[1].c_str(), (int)(view.find(2) == view.cend()));
+}
+
+int main() {
+	test_against_map();
+	test_adopt();
+	test_exceptions();
+	return 0;
+}
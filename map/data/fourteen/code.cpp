@@ -0,0 +1,83 @@
+#include "key_search.hpp"
+#include "btree_map.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+#if defined(__SSE2__)
+static_assert(sjtu::key_search<long, std::less<long>>::vectorized);
+static_assert(sjtu::key_search<long long, std::less<long long>>::vectorized);
+#endif
+
+template <class Key>
+int check_kernel(const char *name) {
+	typedef sjtu::key_search<Key, std::less<Key>> search;
+	Key keys[70];
+	int errors = 0;
+	for (int n = 0; n <= 70; ++n) {
+		for (int i = 0; i < n; ++i) keys[i] = Key(3 * i - 40);
+		for (int probe = -45; probe <= 3 * n - 35; ++probe) {
+			Key key = Key(probe);
+			int lower = std::lower_bound(keys, keys + n, key) - keys;
+			int upper = std::upper_bound(keys, keys + n, key) - keys;
+			if (search::lower(keys, n, key, std::less<Key>()) != lower) ++errors;
+			if (search::upper(keys, n, key, std::less<Key>()) != upper) ++errors;
+		}
+	}
+	printf("%s: %d errors\n", name, errors);
+	return errors;
+}
+
+// 8 byte keys whose high and low halves both differ, pairs of them share
+// a high half, and the low halves use their top bit
+template <class Key>
+int check_wide(const char *name) {
+	typedef sjtu::key_search<Key, std::less<Key>> search;
+	const long long steps[] = {-0x80000001LL, -1, 0, 1, 0x7fffffffLL};
+	Key keys[70];
+	int errors = 0;
+	for (int n = 0; n <= 70; ++n) {
+		for (int i = 0; i < n; ++i) keys[i] = Key((i - 35) * 0x80000000LL + i % 3);
+		for (int j = 0; j < n; ++j) {
+			for (long long step : steps) {
+				Key key = Key(keys[j] + step);
+				int lower = std::lower_bound(keys, keys + n, key) - keys;
+				int upper = std::upper_bound(keys, keys + n, key) - keys;
+				if (search::lower(keys, n, key, std::less<Key>()) != lower) ++errors;
+				if (search::upper(keys, n, key, std::less<Key>()) != upper) ++errors;
+			}
+		}
+	}
+	printf("%s wide: %d errors\n", name, errors);
+	return errors;
+}
+
+template <class Key>
+void check_map(const char *name) {
+	sjtu::btree_map<Key, int> m;
+	for (int i = 0; i < 5000; ++i) m[Key((i * 7919) % 5000 * 2)] = i;
+	long long found = 0, bounds = 0;
+	for (int i = -3; i < 10003; ++i) {
+		found += m.count(Key(i));
+		auto lb = m.lower_bound(Key(i));
+		auto ub = m.upper_bound(Key(i));
+		if (lb != m.end()) bounds += (long long)lb->first;
+		if (ub != m.end()) bounds += (long long)ub->first;
+	}
+	printf("%s: %lld %lld\n", name, found, bounds);
+}
+
+int main() {
+	check_kernel<int>("int");
+	check_kernel<long long>("long long");
+	check_kernel<long>("long");
+	check_wide<long long>("long long");
+	check_wide<long>("long");
+	check_kernel<double>("double");
+	check_kernel<short>("short");
+	check_map<int>("int");
+	check_map<long long>("long long");
+	check_map<long>("long");
+	check_map<double>("double");
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include "map.hpp"
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+
+void test_against_std() {
+	std::mt19937 gen(2025);
+	sjtu::map<int, int> m;
+	std::map<int, int> s;
+	for (int i = 0; i < 20000; ++i) {
+		int k = (int)(gen() % 100000);
+		m[k] = i;
+		s[k] = i;
+	}
+	int mismatches = 0;
+	long long lows = 0, highs = 0, ranges = 0;
+	for (int q = 0; q < 20000; ++q) {
+		int k = (int)(gen() % 100002) - 1;
+		auto ml = m.lower_bound(k);
+		auto sl = s.lower_bound(k);
+		mismatches += (ml == m.end()) != (sl == s.end()) || (sl != s.end() && ml->first != sl->first);
+		auto mu = m.upper_bound(k);
+		auto su = s.upper_bound(k);
+		mismatches += (mu == m.end()) != (su == s.end()) || (su != s.end() && mu->first != su->first);
+		lows += sl == s.end() ? -1 : sl->first;
+		highs += su == s.end() ? -1 : su->first;
+		auto er = m.equal_range(k);
+		int in = 0;
+		for (auto it = er.first; it != er.second; ++it) {
+			++in;
+		}
+		mismatches += in != (int)s.count(k);
+
+		int lo = (int)(gen() % 100000), hi = lo + (int)(gen() % 500);
+		long long got = 0, want = 0;
+		m.for_each_in_range(lo, hi, [&](sjtu::pair<const int, int> &v) { got += v.first ^ v.second; });
+		for (auto it = s.lower_bound(lo); it != s.end() && it->first < hi; ++it) {
+			want += it->first ^ it->second;
+		}
+		mismatches += got != want;
+		ranges += got;
+	}
+	printf("%d %lld %lld %lld\n", mismatches, lows, highs, ranges);
+}
+
+void test_edges() {
+	sjtu::map<int, std::string> m;
+	printf("%d %d\n", m.lower_bound(1) == m.end(), m.upper_bound(1) == m.end());
+	for (int i = 10; i <= 50; i += 10) {
+		m[i] = std::to_string(i);
+	}
+	const auto &cm = m;
+	printf("%s %s %d\n", cm.lower_bound(20)->second.c_str(), cm.upper_bound(20)->second.c_str(),
+	       cm.upper_bound(50) == cm.cend());
+	auto er = cm.equal_range(25);
+	printf("%d %s\n", er.first == er.second, er.first->second.c_str());
+	// bounds are ordinary iterators
+	auto it = m.lower_bound(31);
+	--it;
+	it->second += "!";
+	m.for_each_in_range(10, 40, [](sjtu::pair<const int, std::string> &v) { v.second += "+"; });
+	cm.for_each_in_range(0, 100, [](const sjtu::pair<const int, std::string> &v) { printf("%s ", v.second.c_str()); });
+	cm.for_each_in_range(40, 20, [](const sjtu::pair<const int, std::string> &) { printf("never"); });
+	printf("\n");
+}
+
+void test_transparent() {
+	sjtu::map<std::string, int, std::less<>> m;
+	m["2025-01-01"] = 1;
+	m["2025-02-01"] = 2;
+	m["2025-03-01"] = 3;
+	const char *from = "2025-01-15";
+	printf("%d %d\n", m.lower_bound(from)->second, m.upper_bound("2025-02-01")->second);
+}
+
+int main() {
+	test_against_std();
+	test_edges();
+	test_transparent();
+	return 0;
+}
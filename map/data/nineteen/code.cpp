@@ -0,0 +1,96 @@
+#include "map.hpp"
+#include <cstdio>
+
+int alive = 0, copies_left = -1;
+
+struct Fragile {
+	int val;
+	Fragile(int val) : val(val) { ++alive; }
+	Fragile(const Fragile &other) : val(other.val) {
+		if (copies_left == 0) throw sjtu::runtime_error();
+		if (copies_left > 0) --copies_left;
+		++alive;
+	}
+	~Fragile() { --alive; }
+};
+
+const int N = 1000000;
+
+// walks both maps forwards and backwards, they must agree element by element
+template<class Map>
+bool same_order(const Map &a, const Map &b) {
+	if (a.size() != b.size()) return false;
+	auto it = a.cbegin();
+	for (auto jt = b.cbegin(); jt != b.cend(); ++it, ++jt) {
+		if (it->first != jt->first || it->second.val != jt->second.val) return false;
+	}
+	if (it != a.cend()) return false;
+	if (a.size() == 0) return true;
+	auto rt = a.cend(), st = b.cend();
+	do {
+		--rt;
+		--st;
+		if (rt->first != st->first) return false;
+	} while (st != b.cbegin());
+	return rt == a.cbegin();
+}
+
+template<class Map>
+bool ascending(const Map &m) {
+	int expected = 0;
+	for (auto it = m.cbegin(); it != m.cend(); ++it, ++expected) {
+		if (it->first != expected || it->second.val != -expected) return false;
+	}
+	return expected == N;
+}
+
+template<class Map>
+void test_deep(const char *name) {
+	{
+		Map m;
+		for (int i = 0; i < N; ++i) m.try_emplace(i, -i);
+		int ok = ascending(m);
+
+		{
+			Map copy(m);
+			ok += same_order(copy, m) && alive == 2 * N;
+			copy.erase(copy.find(N / 2));
+			copy.try_emplace(N, -N);
+			ok += copy.size() == N && m.count(N / 2) && !m.count(N);
+		}
+		ok += alive == N;
+
+		int threw = 0;
+		for (int after : {0, N / 3, N - 1}) {
+			copies_left = after;
+			try {
+				Map copy(m);
+			} catch (sjtu::runtime_error &) {
+				++threw;
+			}
+			copies_left = -1;
+			ok += alive == N && ascending(m);
+		}
+
+		Map target;
+		for (int i = 0; i < 1000; ++i) target.try_emplace(-i, i);
+		copies_left = N / 2;
+		try {
+			target = m;
+		} catch (sjtu::runtime_error &) {
+			++threw;
+		}
+		copies_left = -1;
+		ok += target.size() == 1000 && alive == N + 1000;
+		target = m;
+		ok += same_order(target, m) && alive == 2 * N;
+		printf("%s: %d %d\n", name, threw, ok);
+	}
+	printf("%s: %d alive\n", name, alive);
+}
+
+int main() {
+	test_deep<sjtu::map<int, Fragile>>("plain");
+	test_deep<sjtu::map<int, Fragile, std::less<int>, true, true>>("ranked linked");
+	return 0;
+}
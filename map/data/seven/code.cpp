@@ -0,0 +1,78 @@
+#include "map.hpp"
+#include <compare>
+#include <cstdio>
+#include <string>
+
+long long calls = 0;
+
+struct CountingLess {
+	bool operator()(const std::string &a, const std::string &b) const {
+		++calls;
+		return a < b;
+	}
+};
+
+struct CountingThreeWay {
+	std::strong_ordering operator()(const std::string &a, const std::string &b) const {
+		++calls;
+		return a <=> b;
+	}
+};
+
+// a three-way comparator sorting in descending order
+struct Descending {
+	std::weak_ordering operator()(int a, int b) const {
+		return b <=> a;
+	}
+};
+
+std::string key(int i) {
+	return "key-" + std::to_string(i * 7919 % 100003);
+}
+
+template<class Compare>
+void test_strings(const char *name) {
+	const int n = 1 << 16;
+	sjtu::map<std::string, int, Compare> m;
+	for (int i = 0; i < n; ++i) {
+		m[key(i)] = i;
+	}
+	calls = 0;
+	long long sum = 0;
+	for (int i = 0; i < n; ++i) {
+		sum += m.find(key(i))->second;
+	}
+	int missing = 0;
+	for (int i = n; i < n + 1000; ++i) {
+		missing += m.find(key(i)) == m.end();
+	}
+	// an AVL tree of 2^16 keys is at most 23 levels deep
+	printf("%s %lld %d %d\n", name, sum, missing, calls <= 24LL * (n + 1000));
+	int order_ok = 1;
+	auto prev = m.cbegin();
+	for (auto it = ++m.cbegin(); it != m.cend(); prev = it, ++it) {
+		order_ok &= prev->first < it->first;
+	}
+	printf("%d %d\n", (int)m.size(), order_ok);
+}
+
+void test_descending() {
+	sjtu::map<int, int, Descending> m;
+	for (int i = 0; i < 20; ++i) {
+		m.insert(sjtu::pair<const int, int>(i * 37 % 20, i));
+	}
+	m.erase(m.find(7));
+	printf("%d %d %d", (int)m.size(), (int)m.count(7), m.at(3));
+	for (auto it = m.cbegin(); it != m.cend(); ++it) {
+		printf(" %d", it->first);
+	}
+	printf("\n");
+}
+
+int main() {
+	test_strings<CountingLess>("less");
+	test_strings<CountingThreeWay>("three-way");
+	test_strings<std::compare_three_way>("compare_three_way");
+	test_descending();
+	return 0;
+}
@@ -0,0 +1,126 @@
+#include "map.hpp"
+#include "unordered_map.hpp"
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+int alive = 0, copies_left = -1;
+
+struct Fragile {
+	int val;
+	Fragile(int val) : val(val) { ++alive; }
+	Fragile(const Fragile &other) : val(other.val) {
+		if (copies_left == 0) throw sjtu::runtime_error();
+		if (copies_left > 0) --copies_left;
+		++alive;
+	}
+	~Fragile() { --alive; }
+};
+
+unsigned seed = 17;
+
+int next_rand() {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 8) & 0xffff;
+}
+
+void test_against_map() {
+	sjtu::unordered_map<int, std::string> hash;
+	sjtu::map<int, std::string> tree;
+	for (int step = 0; step < 300000; ++step) {
+		int key = next_rand() % 5000;
+		int op = next_rand() % 4;
+		if (op < 2) {
+			sjtu::pair<const int, std::string> value(key, std::to_string(key));
+			[[maybe_unused]] bool a = hash.insert(value).second;
+			[[maybe_unused]] bool b = tree.insert(value).second;
+			assert(a == b);
+		} else if (op == 2) {
+			auto it = hash.find(key);
+			assert((it == hash.end()) == (tree.count(key) == 0));
+			if (it != hash.end()) {
+				hash.erase(it);
+				tree.erase(tree.find(key));
+			}
+		} else {
+			hash[key] += "#";
+			tree[key] += "#";
+		}
+	}
+	assert(hash.size() == tree.size());
+	long long sum = 0;
+	size_t seen = 0;
+	for (auto it = hash.cbegin(); it != hash.cend(); ++it, ++seen) {
+		assert(tree.at(it->first) == it->second);
+		sum += it->first;
+	}
+	assert(seen == tree.size());
+	printf("%d %lld\n", (int)hash.size(), sum);
+
+	sjtu::unordered_map<int, std::string> copy(hash);
+	hash.clear();
+	for (auto it = tree.cbegin(); it != tree.cend(); ++it) assert(copy.at(it->first) == it->second);
+	printf("%d %d %d\n", (int)hash.size(), (int)copy.size(), (int)(hash.begin() == hash.end()));
+
+	sjtu::unordered_map<std::string, int> words;
+	for (int i = 0; i < 20000; ++i) words[std::to_string(i % 7000)] += i;
+	printf("%d %d %d\n", (int)words.size(), words.at("6999"), (int)words.count("7000"));
+}
+
+void test_exceptions() {
+	sjtu::unordered_map<int, std::string> hash;
+	try {
+		hash.at(1);
+	} catch (sjtu::index_out_of_bound &) {
+		puts("at: index_out_of_bound");
+	}
+	try {
+		hash.erase(hash.end());
+	} catch (sjtu::invalid_iterator &) {
+		puts("erase end: invalid_iterator");
+	}
+	hash[1] = "one";
+	try {
+		auto it = hash.begin();
+		++it;
+		++it;
+	} catch (sjtu::invalid_iterator &) {
+		puts("++end: invalid_iterator");
+	}
+	sjtu::unordered_map<int, std::string> other(hash);
+	try {
+		hash.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		puts("erase other: invalid_iterator");
+	}
+	const sjtu::unordered_map<int, std::string> &view = hash;
+	printf("%s %s\n", view.at(1).c_str(), view[1].c_str());
+}
+
+void test_throwing_rehash() {
+	{
+		sjtu::unordered_map<int, Fragile> hash;
+		int inserted = 0;
+		copies_left = 1000;
+		try {
+			for (int i = 0; i < 5000; ++i) {
+				hash.insert(sjtu::pair<const int, Fragile>(i, Fragile(i)));
+				++inserted;
+			}
+		} catch (sjtu::runtime_error &) {
+			puts("insert: runtime_error");
+		}
+		copies_left = -1;
+		bool intact = (int)hash.size() == inserted;
+		for (int i = 0; i < inserted; ++i) intact = intact && hash.at(i).val == i;
+		printf("%d %d\n", (int)intact, alive == inserted);
+	}
+	printf("%d\n", alive);
+}
+
+int main() {
+	test_against_map();
+	test_exceptions();
+	test_throwing_rehash();
+	return 0;
+}
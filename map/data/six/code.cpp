@@ -0,0 +1,134 @@
+#include "map.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template<class Map>
+bool check(const Map &m) {
+	// walks forwards and backwards, keys must be strictly increasing
+	size_t n = 0;
+	auto it = m.cbegin();
+	for (auto prev = it; it != m.cend(); prev = it, ++it, ++n) {
+		if (n && !(prev->first < it->first)) return false;
+	}
+	while (it != m.cbegin()) {
+		--it;
+		--n;
+	}
+	return n == 0;
+}
+
+void test_constructor() {
+	std::vector<sjtu::pair<int, std::string>> v;
+	for (int i = 0; i < 100000; ++i) {
+		v.push_back(sjtu::pair<int, std::string>(i * 2, std::to_string(i)));
+	}
+	sjtu::map<int, std::string> m(v.begin(), v.end());
+	printf("%d %d %s %s\n", (int)m.size(), check(m), m.at(0).c_str(), m.at(199998).c_str());
+	for (int i = 0; i < 100000; i += 3) {
+		m.erase(m.find(i * 2));
+	}
+	m[1] = "one";
+	printf("%d %d %d %s\n", (int)m.size(), check(m), (int)m.count(6), m[1].c_str());
+}
+
+void test_duplicates_and_unsorted() {
+	int keys[] = {1, 1, 2, 3, 3, 3, 9};
+	std::vector<sjtu::pair<int, int>> v;
+	for (int i = 0; i < 7; ++i) {
+		v.push_back(sjtu::pair<int, int>(keys[i], i));
+	}
+	sjtu::map<int, int> m(v.begin(), v.end());
+	for (auto it = m.cbegin(); it != m.cend(); ++it) {
+		printf("%d:%d ", it->first, it->second);
+	}
+	printf("%d\n", check(m));
+
+	int shuffled[] = {5, 3, 8, 3, 1, 9, 2};
+	v.clear();
+	for (int i = 0; i < 7; ++i) {
+		v.push_back(sjtu::pair<int, int>(shuffled[i], i));
+	}
+	sjtu::map<int, int> u(v.begin(), v.end());
+	for (auto it = u.cbegin(); it != u.cend(); ++it) {
+		printf("%d:%d ", it->first, it->second);
+	}
+	printf("%d\n", check(u));
+}
+
+void test_insert_sorted() {
+	sjtu::map<int, int> m;
+	for (int i = 0; i < 1000; i += 2) {
+		m[i] = -i;
+	}
+	auto kept = m.find(500);
+	std::vector<sjtu::pair<int, int>> v;
+	for (int i = 0; i < 2000; i += 3) {
+		v.push_back(sjtu::pair<int, int>(i, i));
+	}
+	m.insert_sorted(v.begin(), v.end());
+	printf("%d %d %d %d %d %d\n", (int)m.size(), check(m), m.at(6), m.at(3), m.at(1998), kept->second);
+	// a small batch goes in one by one
+	v.clear();
+	v.push_back(sjtu::pair<int, int>(1, 1));
+	v.push_back(sjtu::pair<int, int>(5000, 5000));
+	m.insert_sorted(v.begin(), v.end());
+	printf("%d %d %d\n", (int)m.size(), check(m), (--m.end())->first);
+	m.insert_sorted(v.begin(), v.begin());
+	sjtu::map<int, int> empty;
+	empty.insert_sorted(v.begin(), v.end());
+	printf("%d %d\n", (int)empty.size(), check(empty));
+}
+
+int calls_left = -1;
+
+// std::less that throws once calls_left comparisons have been made
+struct ThrowingLess {
+	bool operator()(int a, int b) const {
+		if (calls_left == 0) throw std::runtime_error("compare");
+		if (calls_left > 0) --calls_left;
+		return a < b;
+	}
+};
+
+template<class Map>
+void test_throwing_merge() {
+	Map m;
+	for (int i = 0; i < 1000; i += 2) {
+		m[i] = i;
+	}
+	std::vector<sjtu::pair<int, int>> v;
+	for (int i = 1; i < 1000; i += 4) {
+		v.push_back(sjtu::pair<int, int>(i, i));
+	}
+	// two comparisons per element to check the order, then the merge starts
+	calls_left = 2 * ((int)v.size() - 1) + 300;
+	try {
+		m.insert_sorted(v.begin(), v.end());
+	} catch (std::runtime_error &) {
+		printf("merge threw: ");
+	}
+	calls_left = -1;
+	bool old_kept = true;
+	for (int i = 0; i < 1000; i += 2) {
+		old_kept = old_kept && m.count(i) && m.at(i) == i;
+	}
+	size_t walked = 0;
+	for (auto it = m.cbegin(); it != m.cend(); ++it) {
+		++walked;
+	}
+	printf("%d %d %d %d\n", (int)m.size(), (int)(walked == m.size()), check(m), old_kept);
+	m[2000] = 2000;
+	m.erase(m.find(0));
+	printf("%d %d %d\n", (int)m.size(), check(m), (--m.end())->first);
+}
+
+int main() {
+	test_constructor();
+	test_duplicates_and_unsorted();
+	test_insert_sorted();
+	test_throwing_merge<sjtu::map<int, int, ThrowingLess>>();
+	test_throwing_merge<sjtu::map<int, int, ThrowingLess, false, true>>();
+	return 0;
+}
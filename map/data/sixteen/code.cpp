@@ -0,0 +1,128 @@
+#include "map.hpp"
+#include <cassert>
+#include <compare>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_nothrow_move_constructible_v<sjtu::frozen_map<int, std::string>>);
+static_assert(std::is_nothrow_default_constructible_v<sjtu::frozen_map<int, std::string>>);
+
+int alive = 0, copies_left = -1;
+
+struct Fragile {
+	int val;
+	Fragile(int val) : val(val) { ++alive; }
+	Fragile(const Fragile &other) : val(other.val) {
+		if (copies_left == 0) throw sjtu::runtime_error();
+		if (copies_left > 0) --copies_left;
+		++alive;
+	}
+	~Fragile() { --alive; }
+};
+
+void test_against_map() {
+	sjtu::map<int, std::string> m;
+	for (int i = 0; i < 100000; ++i) {
+		int key = (int)((i * 48271LL) % 200003);
+		m[key] = std::to_string(i);
+	}
+	sjtu::frozen_map<int, std::string> frozen = m.freeze();
+	m[-1] = "later";
+	printf("%d %d\n", (int)m.size(), (int)frozen.size());
+
+	auto it = frozen.cbegin();
+	for (auto jt = m.cbegin(); jt != m.cend(); ++jt) {
+		if (jt->first == -1) continue;
+		assert(it->first == jt->first && (*it).second == jt->second);
+		++it;
+	}
+	assert(it == frozen.cend());
+
+	long long hits = 0, lower_sum = 0, upper_sum = 0;
+	for (int key = -3; key < 200010; ++key) {
+		hits += frozen.count(key);
+		auto lb = frozen.lower_bound(key);
+		auto ub = frozen.upper_bound(key);
+		if (lb != frozen.end()) lower_sum += lb->first;
+		if (ub != frozen.end()) upper_sum += ub->first;
+		[[maybe_unused]] auto found = frozen.find(key);
+		assert((found == frozen.end()) == (m.count(key) == 0 || key == -1));
+	}
+	printf("%lld %lld %lld\n", hits, lower_sum, upper_sum);
+
+	auto last = frozen.end();
+	--last;
+	printf("%d %s %s\n", last->first, last->second.c_str(), frozen.at(last->first).c_str());
+
+	sjtu::frozen_map<int, std::string> copy(frozen);
+	sjtu::frozen_map<int, std::string> moved(std::move(frozen));
+	printf("%d %d %d\n", (int)copy.size(), (int)moved.size(), (int)frozen.empty());
+}
+
+void test_exceptions() {
+	sjtu::map<int, std::string> m;
+	auto empty = m.freeze();
+	try {
+		empty.at(1);
+	} catch (sjtu::index_out_of_bound &) {
+		puts("at: index_out_of_bound");
+	}
+	try {
+		--empty.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("--end: invalid_iterator");
+	}
+	m[1] = "one";
+	auto one = m.freeze();
+	try {
+		--one.begin();
+	} catch (sjtu::invalid_iterator &) {
+		puts("--begin: invalid_iterator");
+	}
+	try {
+		*one.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("*end: invalid_iterator");
+	}
+	printf("%s\n", one[1].c_str());
+}
+
+void test_throwing_copy() {
+	{
+		sjtu::map<int, Fragile> m;
+		for (int i = 0; i < 1000; ++i) m.insert(sjtu::pair<const int, Fragile>(i, Fragile(i)));
+		copies_left = 500;
+		try {
+			auto frozen = m.freeze();
+		} catch (sjtu::runtime_error &) {
+			puts("freeze: runtime_error");
+		}
+		copies_left = -1;
+		printf("%d\n", alive);
+	}
+	printf("%d\n", alive);
+}
+
+void test_three_way() {
+	sjtu::map<int, int, std::compare_three_way> m;
+	for (int i = 0; i < 1000; ++i) {
+		m[i * 3] = i;
+	}
+	sjtu::frozen_map<int, int, std::compare_three_way> frozen = m.freeze();
+	long long sum = 0;
+	for (auto it = frozen.cbegin(); it != frozen.cend(); ++it) {
+		sum += it->first;
+	}
+	printf("%d %lld %d %d %d\n", (int)frozen.size(), sum, (int)frozen.count(300), (int)frozen.count(301),
+		frozen.at(2997));
+	printf("%d %d\n", frozen.lower_bound(301)->first, frozen.upper_bound(300)->first);
+}
+
+int main() {
+	test_against_map();
+	test_exceptions();
+	test_throwing_copy();
+	test_three_way();
+	return 0;
+}
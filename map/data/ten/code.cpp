@@ -0,0 +1,54 @@
+#include "map.hpp"
+#include <cstdio>
+#include <functional>
+#include <string>
+
+using ranked = sjtu::map<int, std::string, std::less<int>, true>;
+
+void test_rank_select() {
+	ranked m;
+	for (int i = 0; i < 1000; ++i) {
+		m[i * 37 % 1000 * 2] = std::to_string(i);   // keys 0, 2, ..., 1998
+	}
+	printf("%d %d %d %d\n", (int)m.rank(0), (int)m.rank(1), (int)m.rank(1000), (int)m.rank(5000));
+	printf("%d %d %d %d\n", m.select(0)->first, m.select(499)->first, m.select(999)->first,
+	       m.select(1000) == m.end());
+	// the 90th and 99th percentile
+	printf("%d %d\n", m.select(m.size() * 90 / 100)->first, m.select(m.size() * 99 / 100)->first);
+	for (int i = 0; i < 1000; i += 2) {
+		m.erase(m.find(i * 2));
+	}
+	printf("%d %d %d\n", (int)m.size(), m.select(0)->first, (int)m.rank(1000));
+}
+
+void test_index_distance() {
+	ranked m;
+	for (int i = 0; i < 100; ++i) {
+		m[i] = "";
+	}
+	auto a = m.find(10);
+	auto b = m.find(75);
+	const ranked &cm = m;
+	printf("%d %d %d %d %d\n", (int)cm.index(a), (int)cm.index(b), (int)cm.distance(a, b),
+	       (int)cm.distance(b, a), (int)cm.distance(cm.cbegin(), cm.cend()));
+	ranked other;
+	try {
+		cm.index(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		printf("foreign iterator\n");
+	}
+	// top 3 without walking the whole map
+	for (auto it = m.select(m.size() - 3); it != m.end(); ++it) {
+		printf("%d ", it->first);
+	}
+	printf("\n");
+	ranked copy(m);
+	copy.erase(copy.find(50));
+	printf("%d %d\n", (int)copy.rank(60), (int)m.rank(60));
+}
+
+int main() {
+	test_rank_select();
+	test_index_distance();
+	return 0;
+}
@@ -0,0 +1,296 @@
+#include "map.hpp"
+#include "btree_map.hpp"
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+class Integer {
+public:
+	static int counter;
+	int val;
+
+	Integer(int val) : val(val) {
+		counter++;
+	}
+
+	Integer(const Integer &rhs) {
+		val = rhs.val;
+		counter++;
+	}
+
+	// the maps never assign a key
+	Integer &operator=(const Integer &rhs) = delete;
+
+	~Integer() {
+		counter--;
+	}
+};
+
+int Integer::counter = 0;
+
+class Compare {
+public:
+	bool operator()(const Integer &lhs, const Integer &rhs) const {
+		return lhs.val < rhs.val;
+	}
+};
+
+// a value whose constructor throws when asked to
+struct Bomb {
+	int val;
+	Bomb(int val, bool boom) : val(val) {
+		if (boom) throw sjtu::runtime_error();
+	}
+};
+
+// a key whose copies throw once copies_left runs out
+int copies_left = -1, live_keys = 0;
+
+struct FragileKey {
+	int val;
+	FragileKey(int val) : val(val) { ++live_keys; }
+	FragileKey(const FragileKey &other) : val(other.val) {
+		if (copies_left == 0) throw sjtu::runtime_error();
+		if (copies_left > 0) --copies_left;
+		++live_keys;
+	}
+	FragileKey(FragileKey &&other) noexcept : val(other.val) { ++live_keys; }
+	~FragileKey() { --live_keys; }
+	bool operator<(const FragileKey &rhs) const { return val < rhs.val; }
+};
+
+typedef sjtu::map<Integer, std::string, Compare> AvlMap;
+typedef sjtu::btree_map<Integer, std::string, Compare> BtreeMap;
+
+unsigned seed = 2025;
+
+int next_rand() {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 8) & 0xffff;
+}
+
+template <class Map>
+void same(Map &btree, AvlMap &avl) {
+	assert(btree.size() == avl.size());
+	auto it = btree.cbegin();
+	for (auto jt = avl.cbegin(); jt != avl.cend(); ++jt, ++it) {
+		assert(it != btree.cend());
+		assert(it->first.val == jt->first.val && it->second == jt->second);
+	}
+	assert(it == btree.cend());
+}
+
+void test_against_map() {
+	AvlMap avl;
+	BtreeMap btree;
+	for (int step = 0; step < 200000; ++step) {
+		int key = next_rand() % 20000;
+		int op = next_rand() % 4;
+		if (op < 2) {
+			std::string value = std::to_string(key);
+			[[maybe_unused]] bool a = avl.insert(sjtu::pair<const Integer, std::string>(Integer(key), value)).second;
+			[[maybe_unused]] bool b = btree.insert(sjtu::pair<const Integer, std::string>(Integer(key), value)).second;
+			assert(a == b);
+		} else if (op == 2) {
+			auto it = btree.find(Integer(key));
+			assert((it == btree.end()) == (avl.count(Integer(key)) == 0));
+			if (it != btree.end()) {
+				btree.erase(it);
+				avl.erase(avl.find(Integer(key)));
+			}
+		} else {
+			auto lb = btree.lower_bound(Integer(key));
+			auto ub = btree.upper_bound(Integer(key));
+			[[maybe_unused]] auto alb = avl.lower_bound(Integer(key));
+			[[maybe_unused]] auto aub = avl.upper_bound(Integer(key));
+			assert((lb == btree.end()) == (alb == avl.end()));
+			assert((ub == btree.end()) == (aub == avl.end()));
+			if (lb != btree.end()) assert(lb->first.val == alb->first.val);
+			if (ub != btree.end()) assert(ub->first.val == aub->first.val);
+			if (btree.count(Integer(key))) {
+				btree[Integer(key)] += "+";
+				avl[Integer(key)] += "+";
+			}
+		}
+		if (step % 20000 == 0) same(btree, avl);
+	}
+	same(btree, avl);
+	printf("%d\n", (int)btree.size());
+
+	long long sum = 0;
+	for (auto it = btree.begin(); it != btree.end(); ++it) sum += it->first.val;
+	printf("%lld\n", sum);
+	auto it = btree.end();
+	--it;
+	printf("%d %s\n", it->first.val, it->second.c_str());
+	printf("%d %s\n", btree.begin()->first.val, btree.begin()->second.c_str());
+
+	BtreeMap copy(btree);
+	same(copy, avl);
+	BtreeMap assigned;
+	assigned = copy;
+	copy.clear();
+	same(assigned, avl);
+	printf("%d %d\n", (int)copy.size(), (int)assigned.size());
+
+	while (!avl.empty()) {
+		Integer key = avl.cbegin()->first;
+		avl.erase(avl.find(key));
+		assigned.erase(assigned.find(key));
+	}
+	printf("%d %d\n", (int)assigned.size(), (int)assigned.empty());
+}
+
+void test_exceptions() {
+	BtreeMap btree;
+	try {
+		btree.at(Integer(1));
+	} catch (sjtu::index_out_of_bound &) {
+		puts("at: index_out_of_bound");
+	}
+	try {
+		--btree.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("--end: invalid_iterator");
+	}
+	btree[Integer(1)] = "one";
+	try {
+		--btree.begin();
+	} catch (sjtu::invalid_iterator &) {
+		puts("--begin: invalid_iterator");
+	}
+	try {
+		++btree.end();
+	} catch (sjtu::invalid_iterator &) {
+		puts("++end: invalid_iterator");
+	}
+	BtreeMap other;
+	other[Integer(1)] = "uno";
+	try {
+		btree.erase(other.begin());
+	} catch (sjtu::invalid_iterator &) {
+		puts("erase other: invalid_iterator");
+	}
+	const BtreeMap &view = btree;
+	printf("%s %s\n", view.at(Integer(1)).c_str(), view[Integer(1)].c_str());
+
+	sjtu::btree_map<int, Bomb> bombs;
+	try {
+		bombs.try_emplace(1, 1, true);
+	} catch (sjtu::runtime_error &) {
+		puts("throwing insert: runtime_error");
+	}
+	printf("%d %d %d\n", (int)bombs.size(), (int)bombs.empty(), (int)(bombs.begin() == bombs.end()));
+	for (int i = 0; i < 100; ++i) {
+		bombs.try_emplace(i, i, false);
+	}
+	try {
+		bombs.try_emplace(-1, -1, true);
+	} catch (sjtu::runtime_error &) {
+		puts("throwing insert: runtime_error");
+	}
+	long long sum = 0;
+	for (auto it = bombs.begin(); it != bombs.end(); ++it) sum += it->second.val;
+	printf("%d %lld %d\n", (int)bombs.size(), sum, bombs.begin()->first);
+}
+
+void test_interface() {
+	sjtu::btree_map<std::string, std::string> btree;
+	sjtu::map<std::string, std::string> avl;
+	int agree = 0;
+	for (int i = 0; i < 3000; ++i) {
+		std::string key = std::to_string(i * 7 % 1000);
+		std::string value = std::to_string(i);
+		switch (i % 4) {
+		case 0:
+			agree += btree.emplace(key, value).second == avl.emplace(key, value).second;
+			break;
+		case 1:
+			agree += btree.insert_or_assign(key, value).second == avl.insert_or_assign(key, value).second;
+			break;
+		case 2: {
+			std::string moved_key = key;
+			btree.try_emplace(std::move(moved_key), value);
+			avl.try_emplace(key, value);
+			btree[std::string(key)] += "!";
+			avl[std::string(key)] += "!";
+			break;
+		}
+		default:
+			auto range = btree.equal_range(key);
+			auto avl_range = avl.equal_range(key);
+			bool same_range = (range.first == btree.end()) == (avl_range.first == avl.end())
+				&& (range.second == btree.end()) == (avl_range.second == avl.end());
+			if (range.first != range.second) same_range = same_range && range.first->second == avl_range.first->second;
+			agree += same_range;
+		}
+	}
+	bool same_content = btree.size() == avl.size();
+	auto it = btree.cbegin();
+	for (auto jt = avl.cbegin(); jt != avl.cend(); ++jt, ++it) {
+		same_content = same_content && it->first == jt->first && it->second == jt->second;
+	}
+	const auto &view = btree;
+	auto range = view.equal_range("999");
+	printf("%d %d %d %d\n", agree, (int)btree.size(), (int)same_content, (int)(range.first != range.second));
+}
+
+// every insert may copy the key once; the copy of the separator for a split throws
+void test_throwing_split() {
+	{
+		sjtu::btree_map<FragileKey, int> btree;
+		int failed = 0;
+		for (int i = 0; i < 20000; ++i) {
+			int key = (int)((i * 7919LL) % 20000);
+			copies_left = 1;
+			try {
+				btree.insert(sjtu::pair<const FragileKey, int>(FragileKey(key), key));
+			} catch (sjtu::runtime_error &) {
+				++failed;
+				copies_left = -1;
+				if (btree.count(FragileKey(key)) || (int)btree.size() != i) puts("broken after a failed split");
+				btree.insert(sjtu::pair<const FragileKey, int>(FragileKey(key), key));
+			}
+			copies_left = -1;
+		}
+		long long sum = 0;
+		int prev = -1;
+		bool sorted = true;
+		for (auto it = btree.cbegin(); it != btree.cend(); ++it) {
+			sorted = sorted && prev < it->first.val && it->first.val == it->second;
+			prev = it->first.val;
+			sum += it->second;
+		}
+		int backwards = 0;
+		for (auto it = btree.cend(); it != btree.cbegin(); --it) ++backwards;
+		printf("%d %d %lld %d %d\n", (int)(failed > 0), (int)btree.size(), sum, (int)sorted, backwards);
+		for (int key = 0; key < 20000; key += 2) btree.erase(btree.find(FragileKey(key)));
+		printf("%d %d\n", (int)btree.size(), (int)btree.count(FragileKey(19999)));
+	}
+	printf("%d\n", live_keys);
+
+	// a value that throws while being built, also into full leaves
+	sjtu::btree_map<int, Bomb> bombs;
+	int thrown = 0;
+	for (int i = 0; i < 5000; ++i) {
+		int key = (int)((i * 7919LL) % 5000);
+		try {
+			bombs.try_emplace(key, key, true);
+		} catch (sjtu::runtime_error &) {
+			++thrown;
+		}
+		bombs.try_emplace(key, key, false);
+	}
+	long long sum = 0;
+	for (auto it = bombs.begin(); it != bombs.end(); ++it) sum += it->second.val;
+	printf("%d %d %lld\n", thrown, (int)bombs.size(), sum);
+}
+
+int main() {
+	test_against_map();
+	test_exceptions();
+	test_throwing_split();
+	test_interface();
+	printf("%d\n", Integer::counter);
+	return 0;
+}
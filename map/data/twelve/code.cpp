@@ -0,0 +1,79 @@
+#include "map.hpp"
+#include <cstdio>
+#include <string>
+#include <utility>
+
+int copies = 0, moves = 0, builds = 0;
+
+struct Tracked {
+	std::string s;
+	Tracked() { ++builds; }
+	Tracked(const char *c, int repeat) : s() {
+		for (int i = 0; i < repeat; ++i) s += c;
+		++builds;
+	}
+	Tracked(const std::string &str) : s(str) { ++builds; }
+	Tracked(const Tracked &other) : s(other.s) { ++copies; }
+	Tracked(Tracked &&other) noexcept : s(std::move(other.s)) { ++moves; }
+	Tracked &operator=(const Tracked &other) { s = other.s; ++copies; return *this; }
+	Tracked &operator=(Tracked &&other) noexcept { s = std::move(other.s); ++moves; return *this; }
+};
+
+void report(const char *what) {
+	printf("%s: builds %d copies %d moves %d\n", what, builds, copies, moves);
+	builds = copies = moves = 0;
+}
+
+void test_counts() {
+	sjtu::map<std::string, Tracked> m;
+	report("start");
+	m.try_emplace("a", "ab", 3);
+	report("try_emplace new");
+	auto r = m.try_emplace("a", "zz", 1);
+	printf("%d %s\n", r.second, r.first->second.s.c_str());
+	report("try_emplace existing");
+	m.emplace(std::string("b"), Tracked("b", 2));
+	report("emplace new");
+	m.emplace(std::string("b"), Tracked("c", 2));
+	report("emplace existing");
+	sjtu::pair<const std::string, Tracked> v(std::string("c"), Tracked("c", 1));
+	report("pair");
+	m.insert(std::move(v));
+	report("insert rvalue");
+	m.insert(sjtu::pair<const std::string, Tracked>(std::string("d"), Tracked("d", 1)));
+	report("insert temporary");
+	m["e"];
+	report("operator[] new");
+	m["e"] = Tracked("e", 4);
+	report("operator[] assign");
+	auto ia = m.insert_or_assign("a", Tracked("x", 1));
+	printf("%d %s\n", ia.second, ia.first->second.s.c_str());
+	report("insert_or_assign existing");
+	auto ib = m.insert_or_assign("f", Tracked("f", 1));
+	printf("%d %s\n", ib.second, ib.first->second.s.c_str());
+	report("insert_or_assign new");
+	for (auto it = m.cbegin(); it != m.cend(); ++it) {
+		printf("%s=%s ", it->first.c_str(), it->second.s.c_str());
+	}
+	printf("\n");
+}
+
+void test_keys_not_moved() {
+	sjtu::map<std::string, std::string> m;
+	std::string key = "key";
+	std::string value = "value";
+	m.try_emplace(std::move(key), value);
+	printf("[%s] ", key.c_str());
+	key = "key";
+	m.try_emplace(std::move(key), "other");
+	printf("[%s] %s\n", key.c_str(), m["key"].c_str());
+	std::string k2 = "k2";
+	m[std::move(k2)] = "v2";
+	printf("%d %s\n", (int)m.size(), m.at("k2").c_str());
+}
+
+int main() {
+	test_counts();
+	test_keys_not_moved();
+	return 0;
+}
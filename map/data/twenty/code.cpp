@@ -0,0 +1,119 @@
+#include "map.hpp"
+#include <cstdio>
+#include <vector>
+
+// walks the tree itself, through the friend hook map.hpp leaves for tests
+template<class Key, class T, class Compare, bool Ranked, bool Linked>
+struct sjtu::map_inspector<sjtu::map<Key, T, Compare, Ranked, Linked>> {
+	typedef sjtu::map<Key, T, Compare, Ranked, Linked> Map;
+	typedef typename Map::Node Node;
+
+	const Node *last = nullptr;
+	size_t nodes = 0;
+	int errors = 0;
+
+	// returns the height of node, counting every broken invariant below it
+	int walk(const Node *node, const Node *parent) {
+		if (!node) return 0;
+		if (node->parent != parent) ++errors;
+		int hl = walk(node->ls, node);
+		if (last && !(last->value.first < node->value.first)) ++errors;
+		if constexpr (Linked) {
+			if (node->pred != last || (last && last->succ != node)) ++errors;
+		}
+		last = node;
+		++nodes;
+		size_t before = nodes;
+		int hr = walk(node->rs, node);
+		if (hl - hr > 1 || hr - hl > 1) ++errors;
+		if (node->height != (hl > hr ? hl : hr) + 1) ++errors;
+		if constexpr (Ranked) {
+			size_t left = node->ls ? node->ls->subtree : 0;
+			if (node->subtree != left + 1 + (nodes - before)) ++errors;
+		}
+		return node->height;
+	}
+
+	static int check(const Map &m) {
+		map_inspector probe;
+		probe.walk(m.root, nullptr);
+		if constexpr (Linked) {
+			if (probe.last && probe.last->succ) ++probe.errors;
+		}
+		if (probe.nodes != m.size()) ++probe.errors;
+		return probe.errors;
+	}
+};
+
+unsigned seed = 20;
+
+int next_rand() {
+	seed = seed * 1103515245u + 12345u;
+	return (seed >> 8) & 0xffff;
+}
+
+template<class Map>
+void test_invariants(const char *name) {
+	typedef sjtu::map_inspector<Map> inspector;
+	Map m;
+	int errors = 0, checks = 0;
+	// small keys so erase often hits a node with two children and swaps it
+	// with its successor
+	for (int step = 0; step < 20000; ++step) {
+		int key = next_rand() % 600;
+		int op = next_rand() % 8;
+		if (op < 4) {
+			m[key] = step;
+		} else if (op < 7) {
+			auto it = m.find(key);
+			if (it != m.end()) m.erase(it);
+		} else if (m.size() > 0) {
+			m.erase(m.begin());
+		}
+		errors += inspector::check(m);
+		++checks;
+	}
+
+	// ascending and descending runs grow and shrink the tree at one edge
+	m.clear();
+	for (int i = 0; i < 5000; ++i) m[i] = i;
+	errors += inspector::check(m);
+	for (int i = 0; i < 5000; i += 2) m.erase(m.find(i));
+	errors += inspector::check(m);
+	for (int i = 4999; i >= 0; --i) m[-i] = i;
+	errors += inspector::check(m);
+	while (m.size() > 100) {
+		m.erase(m.begin());
+		auto last = m.end();
+		--last;
+		m.erase(last);
+	}
+	errors += inspector::check(m);
+	checks += 4;
+
+	// the rebuilt tree of insert_sorted must keep up under later edits
+	std::vector<sjtu::pair<int, int>> v;
+	for (int i = 0; i < 3000; ++i) v.push_back(sjtu::pair<int, int>(3 * i + 1, i));
+	m.insert_sorted(v.begin(), v.end());
+	errors += inspector::check(m);
+	for (int step = 0; step < 3000; ++step) {
+		int key = next_rand() % 9000;
+		auto it = m.find(key);
+		if (it != m.end()) {
+			m.erase(it);
+		} else {
+			m[key] = step;
+		}
+		if (step % 100 == 0) errors += inspector::check(m);
+	}
+	errors += inspector::check(m);
+	checks += 32;
+	printf("%s: %d checks %d errors\n", name, checks, errors);
+}
+
+int main() {
+	test_invariants<sjtu::map<int, int>>("plain");
+	test_invariants<sjtu::map<int, int, std::less<int>, true, false>>("ranked");
+	test_invariants<sjtu::map<int, int, std::less<int>, true, true>>("ranked linked");
+	return 0;
+}
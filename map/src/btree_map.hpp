@@ -0,0 +1,1070 @@
+/**
+ * a B+ tree with most of the interface of sjtu::map
+ */
+#ifndef SJTU_BTREE_MAP_HPP
+#define SJTU_BTREE_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "utility.hpp"
+#include "exceptions.hpp"
+#include "node_pool.hpp"
+#include "key_search.hpp"
+
+namespace sjtu {
+  /**
+   * an ordered map like sjtu::map, but a B+ tree: every node holds up to
+   * 64 keys in one contiguous array, so a lookup touches a handful of cache
+   * lines instead of one per level, and the per-element overhead is a
+   * fraction of a pointer instead of three pointers and a height.
+   * The elements live in the leaves, which are chained in key order.
+   *
+   * Unlike sjtu::map, elements move between nodes when the tree changes:
+   * insert and erase invalidate every iterator and reference into the map.
+   * This is deliberate, it is what keeps the elements contiguous.
+   * The lookups, inserts and erase of sjtu::map are all here; insert_sorted,
+   * for_each_in_range, freeze, the heterogeneous lookups and the Ranked and
+   * Linked options are not.
+   */
+  template<
+    class Key,
+    class T,
+    class Compare = std::less<Key> >
+  class btree_map {
+  public:
+    typedef pair<const Key, T> value_type;
+
+  private:
+    static constexpr int clamp_slots(size_t bytes) {
+      return bytes < 16 ? 16 : bytes > 64 ? 64 : static_cast<int>(bytes);
+    }
+
+    // Nodes are sized for about 1 KiB, with 16 to 64 slots.
+    static constexpr int LEAF_SLOTS = clamp_slots(1024 / sizeof(value_type));
+    static constexpr int INNER_SLOTS = clamp_slots(1024 / (sizeof(Key) + sizeof(void*)));
+    static constexpr int LEAF_MIN = LEAF_SLOTS / 2;
+    static constexpr int INNER_MIN = INNER_SLOTS / 2;
+
+    typedef key_search<Key, Compare> search;
+    /**
+     * for the keys key_search vectorizes (plain numbers) a leaf also keeps
+     * a copy of its keys in an array of their own, so the leaf, the last
+     * step of every lookup, is searched with SIMD too. sync_keys refreshes
+     * the copy whenever elements move.
+     */
+    static constexpr bool LEAF_KEYS = search::vectorized;
+    struct no_keys {};
+
+    struct Inner;
+
+    struct Node {
+      Inner* parent = nullptr;
+      int count = 0;  // elements in a leaf, keys in an inner node
+      bool is_leaf;
+
+      explicit Node(bool is_leaf): is_leaf(is_leaf) {
+      }
+    };
+
+    /**
+     * a leaf stores count elements. There is room for one more than
+     * LEAF_SLOTS, so an insert can always go in first and split afterwards.
+     */
+    struct Leaf : Node {
+      Leaf *prev = nullptr, *next = nullptr;
+      [[no_unique_address]] std::conditional_t<LEAF_KEYS, Key[LEAF_SLOTS + 1], no_keys> key_copy;
+      alignas(value_type) unsigned char storage[(LEAF_SLOTS + 1) * sizeof(value_type)];
+
+      Leaf(): Node(true) {
+      }
+
+      value_type* values() {
+        return reinterpret_cast<value_type*>(storage);
+      }
+
+      const Key& key(int i) {
+        return values()[i].first;
+      }
+    };
+
+    /**
+     * an inner node with count keys has count + 1 children. Child i holds
+     * the keys k with keys[i - 1] <= k < keys[i].
+     */
+    struct Inner : Node {
+      alignas(Key) unsigned char key_storage[(INNER_SLOTS + 1) * sizeof(Key)];
+      Node* children[INNER_SLOTS + 2];
+
+      Inner(): Node(false) {
+      }
+
+      Key* keys() {
+        return reinterpret_cast<Key*>(key_storage);
+      }
+    };
+
+    Node* root;
+    Leaf* head;  // leftmost leaf
+    Leaf* tail;  // rightmost leaf
+    size_t _size;
+    Compare cmp;
+    node_pool<Leaf> leaf_pool;
+    node_pool<Inner> inner_pool;
+
+    Leaf* new_leaf() {
+      return new (leaf_pool.allocate()) Leaf();
+    }
+
+    Inner* new_inner() {
+      return new (inner_pool.allocate()) Inner();
+    }
+
+    // moves the object at src into the raw slot dst and ends the life of src
+    template<class V>
+    static void relocate(V* dst, V* src) {
+      new (dst) V(std::move(*src));
+      src->~V();
+    }
+
+    // the key of an element is const, but one that is about to die may give it up
+    static void relocate(value_type* dst, value_type* src) {
+      new (dst) value_type(std::move(const_cast<Key&>(src->first)), std::move(src->second));
+      src->~value_type();
+    }
+
+    // moves [first, first + n) one slot up, leaving first raw
+    template<class V>
+    static void shift_up(V* first, int n) {
+      for(int i = n; i > 0; --i) {
+        relocate(first + i, first + i - 1);
+      }
+    }
+
+    // moves [first + 1, first + 1 + n) one slot down over the raw first
+    template<class V>
+    static void shift_down(V* first, int n) {
+      for(int i = 0; i < n; ++i) {
+        relocate(first + i, first + i + 1);
+      }
+    }
+
+    // overwrites a key in an inner node, Key need not be assignable
+    static void replace_key(Key* slot, Key&& key) {
+      slot->~Key();
+      new (slot) Key(std::move(key));
+    }
+
+    // copies the keys of leaf from slot from on into its key array
+    static void sync_keys(Leaf* leaf, int from) {
+      if constexpr (LEAF_KEYS) {
+        const value_type* values = leaf->values();
+        for(int i = from, n = leaf->count; i < n; ++i) {
+          leaf->key_copy[i] = values[i].first;
+        }
+      }
+    }
+
+    // first i in [0, leaf->count) with leaf->key(i) >= key
+    int lower_index(Leaf* leaf, const Key& key) const {
+      if constexpr (LEAF_KEYS) {
+        return search::lower(leaf->key_copy, leaf->count, key, cmp);
+      }
+      int lo = 0, hi = leaf->count;
+      while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if(cmp(leaf->key(mid), key)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return lo;
+    }
+
+    // first i in [0, leaf->count) with leaf->key(i) > key
+    int upper_index(Leaf* leaf, const Key& key) const {
+      if constexpr (LEAF_KEYS) {
+        return search::upper(leaf->key_copy, leaf->count, key, cmp);
+      }
+      int lo = 0, hi = leaf->count;
+      while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if(cmp(key, leaf->key(mid))) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      return lo;
+    }
+
+    // the child of node whose range holds key
+    Node* child_for(Inner* node, const Key& key) const {
+      return node->children[search::upper(node->keys(), node->count, key, cmp)];
+    }
+
+    Leaf* find_leaf(const Key& key) const {
+      Node* node = root;
+      while(node && !node->is_leaf) {
+        node = child_for(static_cast<Inner*>(node), key);
+      }
+      return static_cast<Leaf*>(node);
+    }
+
+    static int child_index(Inner* parent, Node* child) {
+      int i = 0;
+      while(parent->children[i] != child) {
+        ++i;
+      }
+      return i;
+    }
+
+    /**
+     * the nodes a leaf split can need, taken before the tree changes so that
+     * the split itself cannot fail: the new leaf, one inner node for every
+     * full ancestor, and a new root if all of them are full. The inner
+     * nodes are chained through parent.
+     */
+    struct spare_nodes {
+      Leaf* leaf = nullptr;
+      Inner* inners = nullptr;
+    };
+
+    spare_nodes reserve_split(Leaf* leaf) {
+      spare_nodes spare;
+      try {
+        spare.leaf = new_leaf();
+        for(Node* node = leaf; !node->parent || node->parent->count == INNER_SLOTS; node = node->parent) {
+          Inner* inner = new_inner();
+          inner->parent = spare.inners;
+          spare.inners = inner;
+          if(!node->parent) {
+            break;
+          }
+        }
+      } catch (...) {
+        release(spare);
+        throw;
+      }
+      return spare;
+    }
+
+    void release(spare_nodes& spare) {
+      if(spare.leaf) {
+        leaf_pool.deallocate(spare.leaf);
+      }
+      while(spare.inners) {
+        Inner* next = spare.inners->parent;
+        inner_pool.deallocate(spare.inners);
+        spare.inners = next;
+      }
+    }
+
+    static Inner* take_inner(spare_nodes& spare) {
+      Inner* inner = spare.inners;
+      spare.inners = inner->parent;
+      inner->parent = nullptr;
+      return inner;
+    }
+
+    /**
+     * puts separator and right into the parent of left, just after left,
+     * growing a new root or splitting the parent as needed. The nodes for
+     * that come from spare, nothing here throws.
+     */
+    void insert_into_parent(Node* left, Key&& separator, Node* right, spare_nodes& spare) {
+      Inner* parent = left->parent;
+      if(!parent) {
+        parent = take_inner(spare);
+        new (parent->keys()) Key(std::move(separator));
+        parent->children[0] = left;
+        parent->children[1] = right;
+        parent->count = 1;
+        left->parent = right->parent = parent;
+        root = parent;
+        return;
+      }
+      int i = child_index(parent, left);
+      Key* keys = parent->keys();
+      shift_up(keys + i, parent->count - i);
+      new (keys + i) Key(std::move(separator));
+      for(int j = parent->count + 1; j > i + 1; --j) {
+        parent->children[j] = parent->children[j - 1];
+      }
+      parent->children[i + 1] = right;
+      right->parent = parent;
+      ++parent->count;
+      if(parent->count > INNER_SLOTS) {
+        split_inner(parent, spare);
+      }
+    }
+
+    /**
+     * splits a leaf that overflowed when the element at pos went in and
+     * returns the leaf and index where that element ended up. If the nodes
+     * or the separator cannot be made, the element is destroyed again and
+     * the leaf is as before.
+     */
+    pair<Leaf*, int> split_leaf(Leaf* leaf, int pos) {
+      int keep = leaf->count / 2;
+      spare_nodes spare;
+      std::optional<Key> separator;
+      try {
+        spare = reserve_split(leaf);
+        separator.emplace(leaf->key(keep));
+      } catch (...) {
+        release(spare);
+        value_type* values = leaf->values();
+        values[pos].~value_type();
+        --leaf->count;
+        shift_down(values + pos, leaf->count - pos);
+        sync_keys(leaf, pos);
+        throw;
+      }
+      Leaf* right = spare.leaf;
+      int moved = leaf->count - keep;
+      for(int i = 0; i < moved; ++i) {
+        relocate(right->values() + i, leaf->values() + keep + i);
+      }
+      leaf->count = keep;
+      right->count = moved;
+      sync_keys(right, 0);
+      right->prev = leaf;
+      right->next = leaf->next;
+      (leaf->next ? leaf->next->prev : tail) = right;
+      leaf->next = right;
+      insert_into_parent(leaf, std::move(*separator), right, spare);
+      if(pos < keep) {
+        return {leaf, pos};
+      }
+      return {right, pos - keep};
+    }
+
+    // splits an overfull inner node, the middle key moves up
+    void split_inner(Inner* node, spare_nodes& spare) {
+      Inner* right = take_inner(spare);
+      int mid = node->count / 2;
+      int moved = node->count - mid - 1;
+      Key* keys = node->keys();
+      for(int i = 0; i < moved; ++i) {
+        relocate(right->keys() + i, keys + mid + 1 + i);
+      }
+      for(int i = 0; i <= moved; ++i) {
+        right->children[i] = node->children[mid + 1 + i];
+        right->children[i]->parent = right;
+      }
+      right->count = moved;
+      node->count = mid;
+      Key up(std::move(keys[mid]));
+      keys[mid].~Key();
+      insert_into_parent(node, std::move(up), right, spare);
+    }
+
+    // removes key i and child i + 1 from an inner node
+    static void remove_from_inner(Inner* node, int i) {
+      Key* keys = node->keys();
+      keys[i].~Key();
+      shift_down(keys + i, node->count - i - 1);
+      for(int j = i + 1; j < node->count; ++j) {
+        node->children[j] = node->children[j + 1];
+      }
+      --node->count;
+    }
+
+    // after an inner node lost a key: shrink the root or refill the node
+    void fix_inner(Inner* node) {
+      if(node == root) {
+        if(node->count == 0) {
+          root = node->children[0];
+          root->parent = nullptr;
+          inner_pool.deallocate(node);
+        }
+        return;
+      }
+      if(node->count < INNER_MIN) {
+        rebalance_inner(node);
+      }
+    }
+
+    // appends all of right to left and drops right and its separator
+    void merge_leaves(Leaf* left, Leaf* right, int separator) {
+      for(int i = 0; i < right->count; ++i) {
+        relocate(left->values() + left->count + i, right->values() + i);
+      }
+      left->count += right->count;
+      sync_keys(left, left->count - right->count);
+      left->next = right->next;
+      (right->next ? right->next->prev : tail) = left;
+      Inner* parent = left->parent;
+      leaf_pool.deallocate(right);
+      remove_from_inner(parent, separator);
+      fix_inner(parent);
+    }
+
+    // a leaf fell below LEAF_MIN: borrow from a sibling or merge with one
+    void rebalance_leaf(Leaf* leaf) {
+      Inner* parent = leaf->parent;
+      int i = child_index(parent, leaf);
+      Leaf* left = i > 0 ? static_cast<Leaf*>(parent->children[i - 1]) : nullptr;
+      Leaf* right = i < parent->count ? static_cast<Leaf*>(parent->children[i + 1]) : nullptr;
+      if(left && left->count > LEAF_MIN) {
+        // the new separator is copied first, a throw then changes nothing
+        Key separator(left->key(left->count - 1));
+        shift_up(leaf->values(), leaf->count);
+        relocate(leaf->values(), left->values() + left->count - 1);
+        --left->count;
+        ++leaf->count;
+        sync_keys(leaf, 0);
+        replace_key(parent->keys() + i - 1, std::move(separator));
+      } else if(right && right->count > LEAF_MIN) {
+        Key separator(right->key(1));
+        relocate(leaf->values() + leaf->count, right->values());
+        shift_down(right->values(), right->count - 1);
+        ++leaf->count;
+        --right->count;
+        sync_keys(leaf, leaf->count - 1);
+        sync_keys(right, 0);
+        replace_key(parent->keys() + i, std::move(separator));
+      } else if(left) {
+        merge_leaves(left, leaf, i - 1);
+      } else {
+        merge_leaves(leaf, right, i);
+      }
+    }
+
+    // the same for an inner node, keys rotate through the parent
+    void rebalance_inner(Inner* node) {
+      Inner* parent = node->parent;
+      int i = child_index(parent, node);
+      Inner* left = i > 0 ? static_cast<Inner*>(parent->children[i - 1]) : nullptr;
+      Inner* right = i < parent->count ? static_cast<Inner*>(parent->children[i + 1]) : nullptr;
+      Key* keys = node->keys();
+      if(left && left->count > INNER_MIN) {
+        shift_up(keys, node->count);
+        relocate(keys, parent->keys() + i - 1);
+        for(int j = node->count + 1; j > 0; --j) {
+          node->children[j] = node->children[j - 1];
+        }
+        node->children[0] = left->children[left->count];
+        node->children[0]->parent = node;
+        relocate(parent->keys() + i - 1, left->keys() + left->count - 1);
+        --left->count;
+        ++node->count;
+      } else if(right && right->count > INNER_MIN) {
+        relocate(keys + node->count, parent->keys() + i);
+        node->children[node->count + 1] = right->children[0];
+        node->children[node->count + 1]->parent = node;
+        relocate(parent->keys() + i, right->keys());
+        shift_down(right->keys(), right->count - 1);
+        for(int j = 0; j < right->count; ++j) {
+          right->children[j] = right->children[j + 1];
+        }
+        --right->count;
+        ++node->count;
+      } else {
+        if(left) {
+          right = node;
+          node = left;
+          --i;
+        }
+        // node, separator i and right become one node
+        Key* dst = node->keys();
+        relocate(dst + node->count, parent->keys() + i);
+        shift_down(parent->keys() + i, parent->count - i - 1);
+        for(int j = 0; j < right->count; ++j) {
+          relocate(dst + node->count + 1 + j, right->keys() + j);
+        }
+        for(int j = 0; j <= right->count; ++j) {
+          node->children[node->count + 1 + j] = right->children[j];
+          right->children[j]->parent = node;
+        }
+        node->count += right->count + 1;
+        for(int j = i + 1; j < parent->count; ++j) {
+          parent->children[j] = parent->children[j + 1];
+        }
+        --parent->count;
+        inner_pool.deallocate(right);
+        fix_inner(parent);
+      }
+    }
+
+    // runs the destructors of the keys in inner nodes below node
+    static void destroy_keys(Node* node) {
+      if(!node || node->is_leaf) {
+        return;
+      }
+      Inner* inner = static_cast<Inner*>(node);
+      if constexpr (!std::is_trivially_destructible_v<Key>) {
+        for(int i = 0; i < inner->count; ++i) {
+          inner->keys()[i].~Key();
+        }
+      }
+      for(int i = 0; i <= inner->count; ++i) {
+        destroy_keys(inner->children[i]);
+      }
+    }
+
+    // destroys every element and key and frees all nodes at once
+    void free_nodes() {
+      if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        for(Leaf* leaf = head; leaf; leaf = leaf->next) {
+          for(int i = 0; i < leaf->count; ++i) {
+            leaf->values()[i].~value_type();
+          }
+        }
+      }
+      destroy_keys(root);
+      leaf_pool.release();
+      inner_pool.release();
+      root = nullptr;
+      head = tail = nullptr;
+      _size = 0;
+    }
+
+    /**
+     * copies the subtree src into slot. Nodes are hooked up and counted as
+     * soon as they exist, so after a throw free_nodes() finds everything.
+     */
+    void copy_node(Node* src, Inner* parent, Node*& slot) {
+      if(src->is_leaf) {
+        Leaf* from = static_cast<Leaf*>(src);
+        Leaf* leaf = new_leaf();
+        leaf->parent = parent;
+        slot = leaf;
+        leaf->prev = tail;
+        (tail ? tail->next : head) = leaf;
+        tail = leaf;
+        for(; leaf->count < from->count; ++leaf->count) {
+          new (leaf->values() + leaf->count) value_type(from->values()[leaf->count]);
+        }
+        sync_keys(leaf, 0);
+        return;
+      }
+      Inner* from = static_cast<Inner*>(src);
+      Inner* inner = new_inner();
+      inner->parent = parent;
+      slot = inner;
+      inner->children[0] = nullptr;
+      copy_node(from->children[0], inner, inner->children[0]);
+      for(int i = 0; i < from->count; ++i) {
+        new (inner->keys() + i) Key(from->keys()[i]);
+        inner->children[i + 1] = nullptr;
+        inner->count = i + 1;
+        copy_node(from->children[i + 1], inner, inner->children[i + 1]);
+      }
+    }
+
+    // only the root leaf can become empty, the tree is then empty again
+    void free_root_leaf(Leaf* leaf) {
+      leaf_pool.deallocate(leaf);
+      root = nullptr;
+      head = tail = nullptr;
+    }
+
+    /**
+     * inserts the element built from args at slot pos of leaf, then splits
+     * the leaf if it overflowed. Returns where the element ended up.
+     */
+    template<class... Args>
+    pair<Leaf*, int> insert_at(Leaf* leaf, int pos, Args&&... args) {
+      value_type* values = leaf->values();
+      shift_up(values + pos, leaf->count - pos);
+      try {
+        new (values + pos) value_type(std::forward<Args>(args)...);
+      } catch (...) {
+        shift_down(values + pos, leaf->count - pos);
+        if(leaf->count == 0) {
+          free_root_leaf(leaf);
+        }
+        throw;
+      }
+      ++leaf->count;
+      sync_keys(leaf, pos);
+      if(leaf->count <= LEAF_SLOTS) {
+        ++_size;
+        return {leaf, pos};
+      }
+      pair<Leaf*, int> at = split_leaf(leaf, pos);
+      ++_size;
+      return at;
+    }
+
+    // finds key or the place it belongs; an empty tree gets its first leaf
+    pair<Leaf*, int> locate(const Key& key) {
+      if(!root) {
+        root = head = tail = new_leaf();
+      }
+      Leaf* leaf = find_leaf(key);
+      return {leaf, lower_index(leaf, key)};
+    }
+
+    bool holds(Leaf* leaf, int pos, const Key& key) const {
+      return pos < leaf->count && !cmp(key, leaf->key(pos));
+    }
+
+  public:
+    /**
+     * a bidirectional iterator like map::iterator: ++end() and --begin()
+     * throw invalid_iterator. It is invalidated by any insert or erase.
+     */
+    class const_iterator;
+
+    class iterator {
+    private:
+      btree_map* map_ptr = nullptr;
+      Leaf* leaf = nullptr;
+      int index = 0;
+      friend const_iterator;
+      friend btree_map;
+
+      iterator(btree_map* map_ptr, Leaf* leaf, int index): map_ptr(map_ptr), leaf(leaf), index(index) {
+      }
+
+    public:
+      iterator() = default;
+
+      iterator &operator++() {
+        if(!leaf) {
+          throw invalid_iterator();
+        }
+        if(++index == leaf->count) {
+          leaf = leaf->next;
+          index = 0;
+        }
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      iterator &operator--() {
+        if(!map_ptr) {
+          throw invalid_iterator();
+        }
+        if(leaf && index > 0) {
+          --index;
+          return *this;
+        }
+        Leaf* prev = leaf ? leaf->prev : map_ptr->tail;
+        if(!prev) {
+          throw invalid_iterator();
+        }
+        leaf = prev;
+        index = prev->count - 1;
+        return *this;
+      }
+
+      iterator operator--(int) {
+        iterator temp = *this;
+        --*this;
+        return temp;
+      }
+
+      value_type &operator*() const {
+        if(!leaf) {
+          throw invalid_iterator();
+        }
+        return leaf->values()[index];
+      }
+
+      value_type *operator->() const noexcept {
+        return leaf->values() + index;
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return leaf == rhs.leaf && index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return leaf == rhs.leaf && index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    class const_iterator {
+    private:
+      const btree_map* map_ptr = nullptr;
+      Leaf* leaf = nullptr;
+      int index = 0;
+      friend iterator;
+      friend btree_map;
+
+      const_iterator(const btree_map* map_ptr, Leaf* leaf, int index): map_ptr(map_ptr), leaf(leaf), index(index) {
+      }
+
+    public:
+      const_iterator() = default;
+
+      const_iterator(const iterator &other): map_ptr(other.map_ptr), leaf(other.leaf), index(other.index) {
+      }
+
+      const_iterator &operator++() {
+        if(!leaf) {
+          throw invalid_iterator();
+        }
+        if(++index == leaf->count) {
+          leaf = leaf->next;
+          index = 0;
+        }
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        const_iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      const_iterator &operator--() {
+        if(!map_ptr) {
+          throw invalid_iterator();
+        }
+        if(leaf && index > 0) {
+          --index;
+          return *this;
+        }
+        Leaf* prev = leaf ? leaf->prev : map_ptr->tail;
+        if(!prev) {
+          throw invalid_iterator();
+        }
+        leaf = prev;
+        index = prev->count - 1;
+        return *this;
+      }
+
+      const_iterator operator--(int) {
+        const_iterator temp = *this;
+        --*this;
+        return temp;
+      }
+
+      const value_type &operator*() const {
+        if(!leaf) {
+          throw invalid_iterator();
+        }
+        return leaf->values()[index];
+      }
+
+      const value_type *operator->() const noexcept {
+        return leaf->values() + index;
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return leaf == rhs.leaf && index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return leaf == rhs.leaf && index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    btree_map(): root(nullptr), head(nullptr), tail(nullptr), _size(0) {
+    }
+
+    btree_map(const btree_map &other): btree_map() {
+      if(!other.root) {
+        return;
+      }
+      try {
+        copy_node(other.root, nullptr, root);
+      } catch (...) {
+        free_nodes();
+        throw;
+      }
+      _size = other._size;
+    }
+
+    btree_map &operator=(const btree_map &other) {
+      if(this != &other) {
+        btree_map tmp(other);
+        std::swap(root, tmp.root);
+        std::swap(head, tmp.head);
+        std::swap(tail, tmp.tail);
+        std::swap(_size, tmp._size);
+        std::swap(cmp, tmp.cmp);
+        leaf_pool.swap(tmp.leaf_pool);
+        inner_pool.swap(tmp.inner_pool);
+      }
+      return *this;
+    }
+
+    ~btree_map() {
+      free_nodes();
+    }
+
+    /**
+     * access specified element with bounds checking,
+     * throw index_out_of_bound if key does not exist.
+     */
+    T &at(const Key &key) {
+      Leaf* leaf = find_leaf(key);
+      int pos = leaf ? lower_index(leaf, key) : 0;
+      if(!leaf || !holds(leaf, pos, key)) {
+        throw index_out_of_bound();
+      }
+      return leaf->values()[pos].second;
+    }
+
+    const T &at(const Key &key) const {
+      return const_cast<btree_map*>(this)->at(key);
+    }
+
+    /**
+     * returns the value mapped to key, inserting T() if key does not exist.
+     */
+    T &operator[](const Key &key)
+      requires std::is_default_constructible_v<T>
+    {
+      return try_emplace(key).first->second;
+    }
+
+    T &operator[](Key &&key)
+      requires std::is_default_constructible_v<T>
+    {
+      return try_emplace(std::move(key)).first->second;
+    }
+
+    // behave like at()
+    const T &operator[](const Key &key) const {
+      return at(key);
+    }
+
+    iterator begin() {
+      return iterator(this, head, 0);
+    }
+
+    const_iterator cbegin() const {
+      return const_iterator(this, head, 0);
+    }
+
+    iterator end() {
+      return iterator(this, nullptr, 0);
+    }
+
+    const_iterator cend() const {
+      return const_iterator(this, nullptr, 0);
+    }
+
+    bool empty() const {
+      return _size == 0;
+    }
+
+    size_t size() const {
+      return _size;
+    }
+
+    void clear() {
+      free_nodes();
+    }
+
+    /**
+     * insert an element.
+     * return the iterator to the new element (or the one that prevented the
+     * insertion) and whether the insertion took place.
+     */
+    pair<iterator, bool> insert(const value_type &value) {
+      auto [leaf, pos] = locate(value.first);
+      if(holds(leaf, pos, value.first)) {
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, value);
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    pair<iterator, bool> insert(value_type &&value) {
+      auto [leaf, pos] = locate(value.first);
+      if(holds(leaf, pos, value.first)) {
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, std::move(value));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    /**
+     * constructs the element from args. The key is only known afterwards,
+     * so it is built on the stack first and then moved into its leaf;
+     * try_emplace builds it in place when the key is at hand.
+     */
+    template<class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+      value_type value(std::forward<Args>(args)...);
+      auto [leaf, pos] = locate(value.first);
+      if(holds(leaf, pos, value.first)) {
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, std::move(const_cast<Key&>(value.first)), std::move(value.second));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    /**
+     * if key is absent, inserts (key, T(args...)) built in place; otherwise
+     * does nothing, and neither key nor args are moved from.
+     */
+    template<class... Args>
+    pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+      auto [leaf, pos] = locate(key);
+      if(holds(leaf, pos, key)) {
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, std::piecewise_construct, std::forward_as_tuple(key),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    template<class... Args>
+    pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+      auto [leaf, pos] = locate(key);
+      if(holds(leaf, pos, key)) {
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                         std::forward_as_tuple(std::forward<Args>(args)...));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    /**
+     * assigns obj to the value of key, or inserts (key, obj) if key is absent.
+     * the second of the result is true if an element was inserted.
+     */
+    template<class M>
+    pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+      auto [leaf, pos] = locate(key);
+      if(holds(leaf, pos, key)) {
+        leaf->values()[pos].second = std::forward<M>(obj);
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, key, std::forward<M>(obj));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    template<class M>
+    pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+      auto [leaf, pos] = locate(key);
+      if(holds(leaf, pos, key)) {
+        leaf->values()[pos].second = std::forward<M>(obj);
+        return {iterator(this, leaf, pos), false};
+      }
+      auto [at_leaf, at_pos] = insert_at(leaf, pos, std::move(key), std::forward<M>(obj));
+      return {iterator(this, at_leaf, at_pos), true};
+    }
+
+    /**
+     * erase the element at pos.
+     * throw invalid_iterator if pos is end() or belongs to another map.
+     */
+    void erase(iterator pos) {
+      if(pos.map_ptr != this || !pos.leaf) {
+        throw invalid_iterator();
+      }
+      Leaf* leaf = pos.leaf;
+      value_type* values = leaf->values();
+      values[pos.index].~value_type();
+      shift_down(values + pos.index, leaf->count - pos.index - 1);
+      --leaf->count;
+      --_size;
+      sync_keys(leaf, pos.index);
+      if(leaf == root) {
+        if(leaf->count == 0) {
+          free_root_leaf(leaf);
+        }
+        return;
+      }
+      if(leaf->count < LEAF_MIN) {
+        rebalance_leaf(leaf);
+      }
+    }
+
+    /**
+     * Returns the number of elements with key, either 1 or 0.
+     */
+    size_t count(const Key &key) const {
+      Leaf* leaf = find_leaf(key);
+      return leaf && holds(leaf, lower_index(leaf, key), key);
+    }
+
+    /**
+     * Finds an element with key equivalent to key, end() if there is none.
+     */
+    iterator find(const Key &key) {
+      Leaf* leaf = find_leaf(key);
+      if(!leaf) {
+        return end();
+      }
+      int pos = lower_index(leaf, key);
+      return holds(leaf, pos, key) ? iterator(this, leaf, pos) : end();
+    }
+
+    const_iterator find(const Key &key) const {
+      return const_cast<btree_map*>(this)->find(key);
+    }
+
+    /**
+     * the first element whose key is not less than key, or end().
+     */
+    iterator lower_bound(const Key &key) {
+      Leaf* leaf = find_leaf(key);
+      if(!leaf) {
+        return end();
+      }
+      int pos = lower_index(leaf, key);
+      return pos < leaf->count ? iterator(this, leaf, pos) : iterator(this, leaf->next, 0);
+    }
+
+    const_iterator lower_bound(const Key &key) const {
+      return const_cast<btree_map*>(this)->lower_bound(key);
+    }
+
+    /**
+     * the first element whose key is greater than key, or end().
+     */
+    iterator upper_bound(const Key &key) {
+      Leaf* leaf = find_leaf(key);
+      if(!leaf) {
+        return end();
+      }
+      int pos = upper_index(leaf, key);
+      return pos < leaf->count ? iterator(this, leaf, pos) : iterator(this, leaf->next, 0);
+    }
+
+    const_iterator upper_bound(const Key &key) const {
+      return const_cast<btree_map*>(this)->upper_bound(key);
+    }
+
+    /**
+     * Returns [lower_bound(key), upper_bound(key)), which holds at most one
+     * element since keys are unique.
+     */
+    pair<iterator, iterator> equal_range(const Key &key) {
+      return {lower_bound(key), upper_bound(key)};
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+      return {lower_bound(key), upper_bound(key)};
+    }
+  };
+}
+
+#endif
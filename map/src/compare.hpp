@@ -0,0 +1,18 @@
+#ifndef SJTU_COMPARE_HPP
+#define SJTU_COMPARE_HPP
+
+#include <compare>
+#include <concepts>
+
+namespace sjtu {
+  /**
+   * a comparator that answers with an ordering instead of a bool, like
+   * std::compare_three_way: c(a, b) < 0, == 0 or > 0.
+   */
+  template<class Compare, class Key>
+  concept three_way_compare = requires(const Compare& c, const Key& k) {
+    { c(k, k) } -> std::convertible_to<std::partial_ordering>;
+  };
+}
+
+#endif
@@ -0,0 +1,483 @@
+/**
+ * a sorted array with the interface of sjtu::map
+ */
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "utility.hpp"
+#include "exceptions.hpp"
+#include "key_search.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+  // tag for the flat_map constructor that takes over already sorted arrays
+  struct adopt_sorted_t {
+    explicit adopt_sorted_t() = default;
+  };
+
+  inline constexpr adopt_sorted_t adopt_sorted{};
+
+  /**
+   * an ordered map kept as two sorted sjtu::vectors, one of keys and one
+   * of values, for maps that are built once and then mostly read.
+   * A lookup is a binary search over contiguous keys that finishes with
+   * key_search on the last few, and scanning only the keys never touches
+   * the values.
+   *
+   * insert and erase shift the tail of both arrays, O(size()) each, so
+   * fill a large map through the adopt_sorted constructor instead.
+   * They also invalidate every iterator and reference into the map.
+   *
+   * The elements are not stored as pairs, so an iterator yields a
+   * reference object whose first and second refer into the two arrays.
+   */
+  template<
+    class Key,
+    class T,
+    class Compare = std::less<Key>,
+    class Alloc = adaptive_allocator<> >
+  class flat_map {
+  public:
+    typedef pair<const Key, T> value_type;
+    typedef vector<Key, Alloc> key_container;
+    typedef vector<T, Alloc> mapped_container;
+
+    // what dereferencing an iterator gives
+    struct reference {
+      const Key &first;
+      T &second;
+    };
+
+    struct const_reference {
+      const Key &first;
+      const T &second;
+    };
+
+  private:
+    // binary search stops once this many keys are left, key_search takes over
+    static constexpr size_t SCAN = 32;
+
+    key_container _keys;
+    mapped_container _values;
+    Compare cmp;
+
+    // the first index whose key is not less than key
+    size_t lower_index(const Key &key) const {
+      const Key* first = _keys.data();
+      size_t n = _keys.size();
+      while(n > SCAN) {
+        size_t half = n / 2;
+        if(cmp(first[half], key)) {
+          first += half + 1;
+          n -= half + 1;
+        } else {
+          n = half;
+        }
+      }
+      return (first - _keys.data()) + key_search<Key, Compare>::lower(first, static_cast<int>(n), key, cmp);
+    }
+
+    // the first index whose key is greater than key
+    size_t upper_index(const Key &key) const {
+      const Key* first = _keys.data();
+      size_t n = _keys.size();
+      while(n > SCAN) {
+        size_t half = n / 2;
+        if(cmp(key, first[half])) {
+          n = half;
+        } else {
+          first += half + 1;
+          n -= half + 1;
+        }
+      }
+      return (first - _keys.data()) + key_search<Key, Compare>::upper(first, static_cast<int>(n), key, cmp);
+    }
+
+    bool holds(size_t pos, const Key &key) const {
+      return pos < _keys.size() && !cmp(key, _keys.data()[pos]);
+    }
+
+    // builds the value from args at pos, keeping both arrays in step
+    template<class... Args>
+    void insert_at(size_t pos, const Key &key, Args&&... args) {
+      _keys.insert(pos, key);
+      try {
+        _values.emplace(pos, std::forward<Args>(args)...);
+      } catch (...) {
+        _keys.erase(pos);
+        throw;
+      }
+    }
+
+  public:
+    /**
+     * a bidirectional iterator like map::iterator: ++end() and --begin()
+     * throw invalid_iterator, and so does dereferencing end().
+     * It is invalidated by any insert or erase.
+     */
+    class const_iterator;
+
+    class iterator {
+    private:
+      flat_map* map_ptr = nullptr;
+      size_t index = 0;
+      friend const_iterator;
+      friend flat_map;
+
+      iterator(flat_map* map_ptr, size_t index): map_ptr(map_ptr), index(index) {
+      }
+
+      struct arrow {
+        reference ref;
+
+        reference* operator->() {
+          return &ref;
+        }
+      };
+
+    public:
+      iterator() = default;
+
+      iterator &operator++() {
+        if(!map_ptr || index >= map_ptr->size()) {
+          throw invalid_iterator();
+        }
+        ++index;
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      iterator &operator--() {
+        if(!map_ptr || index == 0) {
+          throw invalid_iterator();
+        }
+        --index;
+        return *this;
+      }
+
+      iterator operator--(int) {
+        iterator temp = *this;
+        --*this;
+        return temp;
+      }
+
+      reference operator*() const {
+        if(!map_ptr || index >= map_ptr->size()) {
+          throw invalid_iterator();
+        }
+        return {map_ptr->_keys.data()[index], map_ptr->_values.data()[index]};
+      }
+
+      arrow operator->() const {
+        return {**this};
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    class const_iterator {
+    private:
+      const flat_map* map_ptr = nullptr;
+      size_t index = 0;
+      friend iterator;
+      friend flat_map;
+
+      const_iterator(const flat_map* map_ptr, size_t index): map_ptr(map_ptr), index(index) {
+      }
+
+      struct arrow {
+        const_reference ref;
+
+        const_reference* operator->() {
+          return &ref;
+        }
+      };
+
+    public:
+      const_iterator() = default;
+
+      const_iterator(const iterator &other): map_ptr(other.map_ptr), index(other.index) {
+      }
+
+      const_iterator &operator++() {
+        if(!map_ptr || index >= map_ptr->size()) {
+          throw invalid_iterator();
+        }
+        ++index;
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        const_iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      const_iterator &operator--() {
+        if(!map_ptr || index == 0) {
+          throw invalid_iterator();
+        }
+        --index;
+        return *this;
+      }
+
+      const_iterator operator--(int) {
+        const_iterator temp = *this;
+        --*this;
+        return temp;
+      }
+
+      const_reference operator*() const {
+        if(!map_ptr || index >= map_ptr->size()) {
+          throw invalid_iterator();
+        }
+        return {map_ptr->_keys.data()[index], map_ptr->_values.data()[index]};
+      }
+
+      arrow operator->() const {
+        return {**this};
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    flat_map() = default;
+
+    flat_map(const flat_map &other) = default;
+
+    // hands over both arrays, nothing is copied
+    flat_map(flat_map &&other) noexcept = default;
+
+    /**
+     * takes over keys and values without copying them. keys must be sorted
+     * and free of duplicates under Compare, values[i] belongs to keys[i].
+     * throw runtime_error if the sizes differ or the keys are out of order,
+     * the vectors have been moved from either way.
+     */
+    flat_map(adopt_sorted_t, key_container &&keys, mapped_container &&values)
+      : _keys(std::move(keys)), _values(std::move(values)) {
+      if(_keys.size() != _values.size()) {
+        throw runtime_error();
+      }
+      const Key* data = _keys.data();
+      for(size_t i = 1; i < _keys.size(); ++i) {
+        if(!cmp(data[i - 1], data[i])) {
+          throw runtime_error();
+        }
+      }
+    }
+
+    flat_map &operator=(const flat_map &other) = default;
+
+    flat_map &operator=(flat_map &&other) noexcept = default;
+
+    ~flat_map() = default;
+
+    /**
+     * access specified element with bounds checking,
+     * throw index_out_of_bound if key does not exist.
+     */
+    T &at(const Key &key) {
+      size_t pos = lower_index(key);
+      if(!holds(pos, key)) {
+        throw index_out_of_bound();
+      }
+      return _values.data()[pos];
+    }
+
+    const T &at(const Key &key) const {
+      size_t pos = lower_index(key);
+      if(!holds(pos, key)) {
+        throw index_out_of_bound();
+      }
+      return _values.data()[pos];
+    }
+
+    /**
+     * returns the value mapped to key, inserting T() if key does not exist.
+     */
+    T &operator[](const Key &key)
+      requires std::is_default_constructible_v<T>
+    {
+      size_t pos = lower_index(key);
+      if(!holds(pos, key)) {
+        insert_at(pos, key);
+      }
+      return _values.data()[pos];
+    }
+
+    // behave like at()
+    const T &operator[](const Key &key) const {
+      return at(key);
+    }
+
+    iterator begin() {
+      return iterator(this, 0);
+    }
+
+    const_iterator cbegin() const {
+      return const_iterator(this, 0);
+    }
+
+    iterator end() {
+      return iterator(this, size());
+    }
+
+    const_iterator cend() const {
+      return const_iterator(this, size());
+    }
+
+    bool empty() const {
+      return _keys.empty();
+    }
+
+    size_t size() const {
+      return _keys.size();
+    }
+
+    void clear() {
+      _keys.clear();
+      _values.clear();
+    }
+
+    // the sorted keys alone, for scans that do not need the values
+    const key_container &keys() const {
+      return _keys;
+    }
+
+    // the values, values()[i] belongs to keys()[i]
+    const mapped_container &values() const {
+      return _values;
+    }
+
+    /**
+     * insert an element.
+     * return the iterator to the new element (or the one that prevented the
+     * insertion) and whether the insertion took place.
+     */
+    pair<iterator, bool> insert(const value_type &value) {
+      size_t pos = lower_index(value.first);
+      if(holds(pos, value.first)) {
+        return {iterator(this, pos), false};
+      }
+      insert_at(pos, value.first, value.second);
+      return {iterator(this, pos), true};
+    }
+
+    // the key is const and copied, the mapped value is moved
+    pair<iterator, bool> insert(value_type &&value) {
+      size_t pos = lower_index(value.first);
+      if(holds(pos, value.first)) {
+        return {iterator(this, pos), false};
+      }
+      insert_at(pos, value.first, std::move(value.second));
+      return {iterator(this, pos), true};
+    }
+
+    /**
+     * if key is absent, inserts (key, T(args...)) built in place.
+     */
+    template<class... Args>
+    pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+      size_t pos = lower_index(key);
+      if(holds(pos, key)) {
+        return {iterator(this, pos), false};
+      }
+      insert_at(pos, key, std::forward<Args>(args)...);
+      return {iterator(this, pos), true};
+    }
+
+    /**
+     * erase the element at pos.
+     * throw invalid_iterator if pos is end() or belongs to another map.
+     */
+    void erase(iterator pos) {
+      if(pos.map_ptr != this || pos.index >= size()) {
+        throw invalid_iterator();
+      }
+      _values.erase(pos.index);
+      _keys.erase(pos.index);
+    }
+
+    /**
+     * Returns the number of elements with key, either 1 or 0.
+     */
+    size_t count(const Key &key) const {
+      return holds(lower_index(key), key);
+    }
+
+    /**
+     * Finds an element with key equivalent to key, end() if there is none.
+     */
+    iterator find(const Key &key) {
+      size_t pos = lower_index(key);
+      return holds(pos, key) ? iterator(this, pos) : end();
+    }
+
+    const_iterator find(const Key &key) const {
+      size_t pos = lower_index(key);
+      return holds(pos, key) ? const_iterator(this, pos) : cend();
+    }
+
+    /**
+     * the first element whose key is not less than key, or end().
+     */
+    iterator lower_bound(const Key &key) {
+      return iterator(this, lower_index(key));
+    }
+
+    const_iterator lower_bound(const Key &key) const {
+      return const_iterator(this, lower_index(key));
+    }
+
+    /**
+     * the first element whose key is greater than key, or end().
+     */
+    iterator upper_bound(const Key &key) {
+      return iterator(this, upper_index(key));
+    }
+
+    const_iterator upper_bound(const Key &key) const {
+      return const_iterator(this, upper_index(key));
+    }
+  };
+}
+
+#endif
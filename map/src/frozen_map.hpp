@@ -0,0 +1,367 @@
+/**
+ * an immutable sorted map in Eytzinger layout, made by map::freeze()
+ */
+#ifndef SJTU_FROZEN_MAP_HPP
+#define SJTU_FROZEN_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "utility.hpp"
+#include "exceptions.hpp"
+#include "compare.hpp"
+
+namespace sjtu {
+  /**
+   * a read-only snapshot of an ordered map, for tables that are built once
+   * and then only searched.
+   * The keys sit in one array in Eytzinger (BFS) order: slot 1 is the root
+   * and slot k has its children at 2k and 2k + 1. A search walks down with
+   * k = 2k + (keys[k] < key), which needs no branch on the comparison, and
+   * the four levels below k share one cache line that is prefetched while
+   * the current level is compared. The values sit in the same order in a
+   * second array.
+   *
+   * Iterators walk the implicit tree in order and yield a reference object
+   * with first and second, like flat_map. Nothing can be changed.
+   */
+  template<
+    class Key,
+    class T,
+    class Compare = std::less<Key> >
+  class frozen_map {
+  public:
+    typedef pair<const Key, T> value_type;
+
+    // what dereferencing an iterator gives
+    struct const_reference {
+      const Key &first;
+      const T &second;
+    };
+
+  private:
+    static constexpr size_t LINE = 64;
+    // keys of one cache line, a search prefetches the slot that many levels down
+    static constexpr size_t PREFETCH_STRIDE = LINE / sizeof(Key) ? LINE / sizeof(Key) : 1;
+    static constexpr size_t KEY_ALIGN = alignof(Key) > LINE ? alignof(Key) : LINE;
+
+    Key* keys;    // keys[1..n], keys[0] is never used
+    T* values;    // values[k] belongs to keys[k]
+    size_t n;
+    Compare cmp;  // a less-than or three-way, like map's
+
+    bool less(const Key &a, const Key &b) const {
+      if constexpr (three_way_compare<Compare, Key>) {
+        return cmp(a, b) < 0;
+      } else {
+        return cmp(a, b);
+      }
+    }
+
+    // the slot that comes after k in key order, 0 after the last one
+    size_t next(size_t k) const {
+      if(2 * k + 1 <= n) {
+        k = 2 * k + 1;
+        while(2 * k <= n) {
+          k = 2 * k;
+        }
+        return k;
+      }
+      while(k & 1) {
+        k >>= 1;
+      }
+      return k >> 1;
+    }
+
+    // the slot before k in key order, the last one for k == 0, 0 before the first
+    size_t prev(size_t k) const {
+      if(k == 0) {
+        k = n ? 1 : 0;
+        while(k && 2 * k + 1 <= n) {
+          k = 2 * k + 1;
+        }
+        return k;
+      }
+      if(2 * k <= n) {
+        k = 2 * k;
+        while(2 * k + 1 <= n) {
+          k = 2 * k + 1;
+        }
+        return k;
+      }
+      while(k && !(k & 1)) {
+        k >>= 1;
+      }
+      return k >> 1;
+    }
+
+    size_t first_slot() const {
+      size_t k = n ? 1 : 0;
+      while(k && 2 * k <= n) {
+        k = 2 * k;
+      }
+      return k;
+    }
+
+    void prefetch(size_t k) const {
+      // computed as an integer, the slot may lie past the end of keys
+      __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(keys) + k * PREFETCH_STRIDE * sizeof(Key)));
+    }
+
+    /**
+     * the slot of the first key for which go_right is false, 0 if there is
+     * none. Going right appends a 1 bit to k, so after falling off the tree
+     * the answer is k with its trailing 1s and the 0 before them removed.
+     */
+    template<class GoRight>
+    size_t descend(GoRight go_right) const {
+      size_t k = 1;
+      while(k <= n) {
+        prefetch(k);
+        k = 2 * k + go_right(keys[k]);
+      }
+      return k >> __builtin_ffsll(static_cast<long long>(~k));
+    }
+
+    size_t lower_slot(const Key &key) const {
+      return descend([this, &key](const Key &k) { return less(k, key); });
+    }
+
+    size_t upper_slot(const Key &key) const {
+      return descend([this, &key](const Key &k) { return !less(key, k); });
+    }
+
+    size_t find_slot(const Key &key) const {
+      size_t k = lower_slot(key);
+      return k && !less(key, keys[k]) ? k : 0;
+    }
+
+    // an empty map has no arrays at all, ::operator delete accepts nullptr
+    void allocate() {
+      if(n == 0) {
+        keys = nullptr;
+        values = nullptr;
+        return;
+      }
+      keys = static_cast<Key*>(::operator new(sizeof(Key) * (n + 1), std::align_val_t(KEY_ALIGN)));
+      try {
+        values = static_cast<T*>(::operator new(sizeof(T) * (n + 1), std::align_val_t(alignof(T))));
+      } catch (...) {
+        ::operator delete(keys, std::align_val_t(KEY_ALIGN));
+        throw;
+      }
+    }
+
+    void deallocate() {
+      ::operator delete(keys, std::align_val_t(KEY_ALIGN));
+      ::operator delete(values, std::align_val_t(alignof(T)));
+    }
+
+    // destroys the first count slots of the in-order walk and frees the arrays
+    void destroy(size_t count) {
+      for(size_t k = first_slot(); count > 0; --count, k = next(k)) {
+        keys[k].~Key();
+        values[k].~T();
+      }
+      deallocate();
+    }
+
+  public:
+    class const_iterator {
+    private:
+      const frozen_map* map_ptr = nullptr;
+      size_t slot = 0;  // 0 is end()
+      friend frozen_map;
+
+      const_iterator(const frozen_map* map_ptr, size_t slot): map_ptr(map_ptr), slot(slot) {
+      }
+
+      struct arrow {
+        const_reference ref;
+
+        const const_reference* operator->() const {
+          return &ref;
+        }
+      };
+
+    public:
+      const_iterator() = default;
+
+      const_iterator &operator++() {
+        if(!slot) {
+          throw invalid_iterator();
+        }
+        slot = map_ptr->next(slot);
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        const_iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      const_iterator &operator--() {
+        size_t prev = map_ptr ? map_ptr->prev(slot) : 0;
+        if(!prev) {
+          throw invalid_iterator();
+        }
+        slot = prev;
+        return *this;
+      }
+
+      const_iterator operator--(int) {
+        const_iterator temp = *this;
+        --*this;
+        return temp;
+      }
+
+      const_reference operator*() const {
+        if(!slot) {
+          throw invalid_iterator();
+        }
+        return {map_ptr->keys[slot], map_ptr->values[slot]};
+      }
+
+      arrow operator->() const {
+        return {**this};
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return slot == rhs.slot && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    typedef const_iterator iterator;
+
+    /**
+     * builds the map from the count elements starting at first, which must
+     * be in increasing key order without duplicates (map::freeze() passes
+     * its own elements).
+     */
+    template<class InputIt>
+    frozen_map(InputIt first, size_t count, const Compare &cmp = Compare()): n(count), cmp(cmp) {
+      allocate();
+      size_t built = 0;
+      try {
+        for(size_t k = first_slot(); built < n; ++built, ++first, k = next(k)) {
+          new (keys + k) Key(first->first);
+          try {
+            new (values + k) T(first->second);
+          } catch (...) {
+            keys[k].~Key();
+            throw;
+          }
+        }
+      } catch (...) {
+        destroy(built);
+        throw;
+      }
+    }
+
+    frozen_map() noexcept: keys(nullptr), values(nullptr), n(0), cmp() {
+    }
+
+    frozen_map(const frozen_map &other): frozen_map(other.begin(), other.n, other.cmp) {
+    }
+
+    frozen_map(frozen_map &&other) noexcept: frozen_map() {
+      swap(other);
+    }
+
+    frozen_map &operator=(frozen_map other) {
+      swap(other);
+      return *this;
+    }
+
+    ~frozen_map() {
+      destroy(n);
+    }
+
+    void swap(frozen_map &other) noexcept {
+      std::swap(keys, other.keys);
+      std::swap(values, other.values);
+      std::swap(n, other.n);
+      std::swap(cmp, other.cmp);
+    }
+
+    /**
+     * access specified element with bounds checking,
+     * throw index_out_of_bound if key does not exist.
+     */
+    const T &at(const Key &key) const {
+      size_t k = find_slot(key);
+      if(!k) {
+        throw index_out_of_bound();
+      }
+      return values[k];
+    }
+
+    // behave like at()
+    const T &operator[](const Key &key) const {
+      return at(key);
+    }
+
+    const_iterator begin() const {
+      return const_iterator(this, first_slot());
+    }
+
+    const_iterator cbegin() const {
+      return begin();
+    }
+
+    const_iterator end() const {
+      return const_iterator(this, 0);
+    }
+
+    const_iterator cend() const {
+      return end();
+    }
+
+    bool empty() const {
+      return n == 0;
+    }
+
+    size_t size() const {
+      return n;
+    }
+
+    /**
+     * Returns the number of elements with key, either 1 or 0.
+     */
+    size_t count(const Key &key) const {
+      return find_slot(key) != 0;
+    }
+
+    /**
+     * Finds an element with key equivalent to key, end() if there is none.
+     */
+    const_iterator find(const Key &key) const {
+      return const_iterator(this, find_slot(key));
+    }
+
+    /**
+     * the first element whose key is not less than key, or end().
+     */
+    const_iterator lower_bound(const Key &key) const {
+      return const_iterator(this, lower_slot(key));
+    }
+
+    /**
+     * the first element whose key is greater than key, or end().
+     */
+    const_iterator upper_bound(const Key &key) const {
+      return const_iterator(this, upper_slot(key));
+    }
+  };
+}
+
+#endif
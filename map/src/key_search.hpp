@@ -0,0 +1,239 @@
+#ifndef SJTU_KEY_SEARCH_HPP
+#define SJTU_KEY_SEARCH_HPP
+
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace sjtu {
+  /**
+   * position searches in a short sorted array of keys, as found in the
+   * nodes of btree_map:
+   *   lower(keys, n, key, cmp)  the first i with !cmp(keys[i], key)
+   *   upper(keys, n, key, cmp)  the first i with cmp(key, keys[i])
+   * The general version is a binary search. For signed 4 and 8 byte
+   * integers (int, long, long long) and double under std::less the keys
+   * are compared 2 to 8 at a time with SIMD instead; the widest
+   * instruction set the compiler targets is used (-mavx2 or -march=native
+   * for AVX2, plain x86-64 gets SSE2).
+   */
+  template<class Key, class Compare>
+  struct key_search {
+    static constexpr bool vectorized = false;
+
+    static int lower(const Key* keys, int n, const Key& key, const Compare& cmp) {
+      int lo = 0, hi = n;
+      while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if(cmp(keys[mid], key)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return lo;
+    }
+
+    static int upper(const Key* keys, int n, const Key& key, const Compare& cmp) {
+      int lo = 0, hi = n;
+      while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        if(cmp(key, keys[mid])) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      return lo;
+    }
+  };
+
+  /**
+   * the SIMD kernels. Every step compares a block of LANES keys against
+   * key and counts the hits with movemask and popcount. The keys are
+   * sorted, so the hits of a block are a prefix and the first block that
+   * is not all hits ends the scan. Less than LANES keys at the end are
+   * compared one by one, nothing past keys[n - 1] is read.
+   */
+  template<class Key>
+  struct simd_scan {
+    static constexpr bool supported = false;
+  };
+
+  // integers the kernels below compare as signed lanes of that many bytes
+  template<class Key, size_t BYTES>
+  concept signed_lane = std::is_integral_v<Key> && std::is_signed_v<Key> && sizeof(Key) == BYTES;
+
+#if defined(__SSE2__)
+  template<class Key>
+    requires signed_lane<Key, 4>
+  struct simd_scan<Key> {
+    static constexpr bool supported = true;
+#if defined(__AVX2__)
+    static constexpr int LANES = 8;
+    typedef __m256i block;
+
+    static block splat(Key key) {
+      return _mm256_set1_epi32(key);
+    }
+
+    static block load(const Key* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    // bit i is set when a[i] > b[i]
+    static unsigned greater(block a, block b) {
+      return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+    }
+#else
+    static constexpr int LANES = 4;
+    typedef __m128i block;
+
+    static block splat(Key key) {
+      return _mm_set1_epi32(key);
+    }
+
+    static block load(const Key* p) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static unsigned greater(block a, block b) {
+      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)));
+    }
+#endif
+  };
+
+  template<class Key>
+    requires signed_lane<Key, 8>
+  struct simd_scan<Key> {
+    static constexpr bool supported = true;
+#if defined(__AVX2__)
+    static constexpr int LANES = 4;
+    typedef __m256i block;
+
+    static block splat(Key key) {
+      return _mm256_set1_epi64x(key);
+    }
+
+    static block load(const Key* p) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static unsigned greater(block a, block b) {
+      return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)));
+    }
+#else
+    static constexpr int LANES = 2;
+    typedef __m128i block;
+
+    static block splat(Key key) {
+      return _mm_set1_epi64x(key);
+    }
+
+    static block load(const Key* p) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+#if defined(__SSE4_2__)
+    static unsigned greater(block a, block b) {
+      return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(a, b)));
+    }
+#else
+    /**
+     * SSE2 has no 64 bit compare, so build it from 32 bit ones: a > b when
+     * the high halves compare greater (signed), or they are equal and the
+     * low halves compare greater (unsigned, by flipping their sign bits).
+     */
+    static unsigned greater(block a, block b) {
+      const block bias = _mm_set_epi32(0, INT_MIN, 0, INT_MIN);
+      block gt = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+      block eq = _mm_cmpeq_epi32(a, b);
+      block low_gt = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+      return _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(gt, _mm_and_si128(eq, low_gt))));
+    }
+#endif
+#endif
+  };
+
+  template<>
+  struct simd_scan<double> {
+    static constexpr bool supported = true;
+#if defined(__AVX__)
+    static constexpr int LANES = 4;
+    typedef __m256d block;
+
+    static block splat(double key) {
+      return _mm256_set1_pd(key);
+    }
+
+    static block load(const double* p) {
+      return _mm256_loadu_pd(p);
+    }
+
+    static unsigned greater(block a, block b) {
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+    }
+#else
+    static constexpr int LANES = 2;
+    typedef __m128d block;
+
+    static block splat(double key) {
+      return _mm_set1_pd(key);
+    }
+
+    static block load(const double* p) {
+      return _mm_loadu_pd(p);
+    }
+
+    static unsigned greater(block a, block b) {
+      return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+    }
+#endif
+  };
+#endif
+
+  template<class Key>
+    requires simd_scan<Key>::supported
+  struct key_search<Key, std::less<Key>> {
+    static constexpr bool vectorized = true;
+    typedef simd_scan<Key> scan;
+    static constexpr unsigned ALL = (1u << scan::LANES) - 1;
+
+    static int lower(const Key* keys, int n, const Key& key, const std::less<Key>&) {
+      auto probe = scan::splat(key);
+      int i = 0;
+      for(; i + scan::LANES <= n; i += scan::LANES) {
+        unsigned less = scan::greater(probe, scan::load(keys + i));
+        if(less != ALL) {
+          return i + __builtin_popcount(less);
+        }
+      }
+      while(i < n && keys[i] < key) {
+        ++i;
+      }
+      return i;
+    }
+
+    static int upper(const Key* keys, int n, const Key& key, const std::less<Key>&) {
+      auto probe = scan::splat(key);
+      int i = 0;
+      for(; i + scan::LANES <= n; i += scan::LANES) {
+        unsigned greater = scan::greater(scan::load(keys + i), probe);
+        if(greater != 0) {
+          return i + __builtin_ctz(greater);
+        }
+      }
+      while(i < n && !(key < keys[i])) {
+        ++i;
+      }
+      return i;
+    }
+  };
+}
+
+#endif
@@ -6,18 +6,41 @@
 
 // only for std::less<T>
 #include <functional>
+#include <compare>
 #include <concepts>
+#include <iterator>
 #include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "utility.hpp"
 #include "exceptions.hpp"
+#include "compare.hpp"
+#include "node_pool.hpp"
+#include "frozen_map.hpp"
 
 
 namespace sjtu {
+  /**
+   * a friend of every map, left undefined here. A test defines it to walk
+   * the tree and check the AVL invariants, see map/data/twenty.
+   */
+  template<class Map>
+  struct map_inspector;
+
+  /**
+   * Ranked = true keeps the size of every subtree in its node, which adds
+   * rank(), select() and distance() in O(log n) for one size_t per node.
+   * Linked = true also chains the nodes in key order, so ++ and -- on an
+   * iterator are one load instead of a climb, for two pointers per node.
+   */
   template<
     class Key,
     class T,
-    class Compare = std::less<Key> >
+    class Compare = std::less<Key>,
+    bool Ranked = false,
+    bool Linked = false>
   //typedef int Key;
   //typedef int T;
   //typedef std::less<int> Compare;
@@ -25,35 +48,35 @@ namespace sjtu {
   public:
     typedef pair<const Key, T> value_type;
   private:
-    struct Node {
+    friend map_inspector<map>;
+
+    struct subtree_size {
+      size_t subtree = 1;
+    };
+    struct no_subtree_size {};
+
+    struct Node;
+    struct in_order_links {
+      Node *pred = nullptr, *succ = nullptr;
+    };
+    struct no_in_order_links {};
+
+    struct Node : std::conditional_t<Ranked, subtree_size, no_subtree_size>,
+                  std::conditional_t<Linked, in_order_links, no_in_order_links> {
       value_type value;
       Node *ls=nullptr,*rs=nullptr,*parent=nullptr;
 
       int height=1;
 
-      explicit Node(const value_type& value):value(value) {
-      }
-
-      ~Node() {
-        delete ls;
-        delete rs;
-      }
-
-      Node* copy() {
-        Node* temp = new Node(value);
-        temp->height = height;
-        if(ls) {
-          temp->ls = ls->copy();
-          temp->ls->parent = temp;
-        }
-        if(rs) {
-          temp->rs = rs->copy();
-          temp->rs->parent=temp;
-        }
-        return temp;
+      // value is constructed in place from args
+      template<class... Args>
+      explicit Node(std::in_place_t, Args&&... args):value(std::forward<Args>(args)...) {
       }
 
       Node* next() {
+        if constexpr (Linked) {
+          return this->succ;
+        }
         Node* temp = this;
         if(rs) {
           temp = rs;
@@ -69,6 +92,9 @@ namespace sjtu {
       }
 
       Node* prev() {
+        if constexpr (Linked) {
+          return this->pred;
+        }
         Node* temp = this;
         if(ls) {
           temp = ls;
@@ -85,6 +111,13 @@ namespace sjtu {
 
       void update_height() {
         height = std::max(ls?ls->height:0,rs?rs->height:0)+1;
+        if constexpr (Ranked) {
+          this->subtree = count(ls)+count(rs)+1;
+        }
+      }
+
+      static size_t count(const Node* node) requires Ranked {
+        return node?node->subtree:0;
       }
 
 
@@ -93,11 +126,189 @@ namespace sjtu {
     Node* root;
     size_t _size;
 
+    // With Linked these are the two ends of the list and is_dirty is unused.
     mutable Node* front_cache;
     mutable Node* last_cache;
     mutable bool is_dirty;
 
+    // Puts a node that was just linked into the tree into the list.
+    void list_insert(Node* node) requires Linked {
+      Node* pred = nullptr;
+      Node* succ = nullptr;
+      if(node->parent) {
+        if(node->parent->ls == node) {
+          succ = node->parent;
+          pred = succ->pred;
+        } else {
+          pred = node->parent;
+          succ = pred->succ;
+        }
+      }
+      node->pred = pred;
+      node->succ = succ;
+      (pred ? pred->succ : front_cache) = node;
+      (succ ? succ->pred : last_cache) = node;
+    }
+
+    void list_erase(Node* node) requires Linked {
+      (node->pred ? node->pred->succ : front_cache) = node->succ;
+      (node->succ ? node->succ->pred : last_cache) = node->pred;
+    }
+
+    // Links a chain (through rs, in key order) into the list, before the tree is built.
+    void list_from_chain(Node* head) requires Linked {
+      Node* pred = nullptr;
+      front_cache = head;
+      for(; head; head = head->rs) {
+        head->pred = pred;
+        if(pred) {
+          pred->succ = head;
+        }
+        pred = head;
+      }
+      if(pred) {
+        pred->succ = nullptr;
+      }
+      last_cache = pred;
+    }
+
+    /**
+     * Compare is either a less-than like std::less, or three-way (see
+     * three_way_compare in compare.hpp). Besides find_unique everything goes through less().
+     */
     Compare cmp;
+    static constexpr bool THREE_WAY = three_way_compare<Compare, Key>;
+    // std::less<> and std::compare_three_way compare a Key with other types
+    static constexpr bool TRANSPARENT = requires { typename Compare::is_transparent; };
+    template<class K>
+    static constexpr bool comparable_with = TRANSPARENT
+      && std::invocable<const Compare&, const K&, const Key&>
+      && std::invocable<const Compare&, const Key&, const K&>;
+
+    template<class A, class B>
+    bool less(const A& a, const B& b) const {
+      if constexpr (THREE_WAY) {
+        return cmp(a,b) < 0;
+      } else {
+        return cmp(a,b);
+      }
+    }
+
+    node_pool<Node> pool;
+
+    template<class... Args>
+    Node* create_node(Args&&... args) {
+      void* p = pool.allocate();
+      try {
+        return new (p) Node(std::in_place, std::forward<Args>(args)...);
+      } catch (...) {
+        pool.deallocate(p);
+        throw;
+      }
+    }
+
+    void destroy_node(Node* node) {
+      node->~Node();
+      pool.deallocate(node);
+    }
+
+    /**
+     * runs the destructors in the subtree, the memory goes back with
+     * pool.release(). Iterative: a node with a left child is rotated right
+     * until the leftmost node is on top, which is destroyed before moving on
+     * to its right child. Only ls/rs are used, the tree is gone afterwards.
+     */
+    static void destroy_values(Node* node) {
+      if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        while(node) {
+          if(node->ls) {
+            Node* temp = node->ls;
+            node->ls = temp->rs;
+            temp->rs = node;
+            node = temp;
+          } else {
+            Node* temp = node->rs;
+            node->~Node();
+            node = temp;
+          }
+        }
+      }
+    }
+
+    // Destroys every element and gives all slabs back at once.
+    void free_nodes() {
+      destroy_values(root);
+      pool.release();
+    }
+
+    /**
+     * copies the tree src into root, iteratively and with the nodes
+     * allocated in key order, so a scan over the copy walks memory forwards.
+     * src is walked in order through its parent pointers. done is the copy of
+     * the subtree finished last; copies still waiting for their right
+     * subtree are chained through their parent pointer, starting at open.
+     * If a copy throws, the pieces are joined into root for free_nodes().
+     * With Linked the list is built on the way, the nodes come in order.
+     */
+    void copy_tree(const Node* src) {
+      Node* done = nullptr;
+      Node* open = nullptr;
+      try {
+        while(src->ls) {
+          src = src->ls;
+        }
+        while(true) {
+          Node* temp = create_node(src->value);
+          temp->height = src->height;
+          if constexpr (Linked) {
+            temp->pred = last_cache;
+            (last_cache ? last_cache->succ : front_cache) = temp;
+            last_cache = temp;
+          }
+          if constexpr (Ranked) {
+            temp->subtree = src->subtree;
+          }
+          if(src->ls) {
+            temp->ls = done;
+            done->parent = temp;
+          }
+          if(src->rs) {
+            temp->parent = open;
+            open = temp;
+            done = nullptr;
+            src = src->rs;
+            while(src->ls) {
+              src = src->ls;
+            }
+            continue;
+          }
+          done = temp;
+          while(src->parent&&src->parent->rs==src) {
+            src = src->parent;
+            Node* up = open->parent;
+            open->rs = done;
+            done->parent = open;
+            done = open;
+            open = up;
+          }
+          src = src->parent;
+          if(!src) {
+            break;
+          }
+        }
+      } catch (...) {
+        while(open) {
+          Node* up = open->parent;
+          open->rs = done;
+          done = open;
+          open = up;
+        }
+        root = done;
+        throw;
+      }
+      done->parent = nullptr;
+      root = done;
+    }
 
 
     struct FindResult {
@@ -110,8 +321,13 @@ namespace sjtu {
        * 任何其他操作都可能导致失效
        *
        */
-      Node* new_node(const value_type& v,map& map) {
-        Node* temp = new Node(v);
+      template<class... Args>
+      Node* new_node(map& map,Args&&... args) {
+        return link(map.create_node(std::forward<Args>(args)...),map);
+      }
+
+      // 把已经构造好的节点挂到插入位置
+      Node* link(Node* temp,map& map) {
         temp->parent = father;
         if (father == nullptr) {
           map.root = temp;
@@ -122,6 +338,9 @@ namespace sjtu {
             father->rs = temp;
           }
         }
+        if constexpr (Linked) {
+          map.list_insert(temp);
+        }
         ++map._size;
         map.is_dirty = true;
         return temp;
@@ -131,23 +350,112 @@ namespace sjtu {
 
     /**
      * @return curr:已存在的节点（若找到） father: 插入位置的父节点
-     *
+     * 每层只调用一次比较器。三路比较器在相等时直接返回；
+     * 只有 less 时记下最后一个不大于 key 的节点，走到底再判断一次是否相等。
      */
-    FindResult find_unique(const Key& key) const{
+    template<class K>
+    FindResult find_unique(const K& key) const{
       Node* temp = root;
       Node* father = nullptr;
       bool comp = false;
-      while(temp) {
-        father = temp;
-        comp = cmp(key,temp->value.first);
-        if(!comp&&!cmp(temp->value.first,key)) {
-          return {temp,nullptr,false};
+      if constexpr (THREE_WAY) {
+        while(temp) {
+          father = temp;
+          auto order = cmp(key,temp->value.first);
+          if(order == 0) {
+            return {temp,nullptr,false};
+          }
+          comp = order < 0;
+          temp = (comp?temp->ls:temp->rs);
+        }
+      } else {
+        Node* candidate = nullptr;
+        while(temp) {
+          father = temp;
+          comp = cmp(key,temp->value.first);
+          if(comp) {
+            temp = temp->ls;
+          } else {
+            candidate = temp;
+            temp = temp->rs;
+          }
+        }
+        if(candidate&&!cmp(candidate->value.first,key)) {
+          return {candidate,nullptr,false};
         }
-        temp = (comp?temp->ls:temp->rs);
       }
       return {nullptr,father,comp};
     }
 
+    // 第一个不小于 key 的节点
+    template<class K>
+    Node* lower_node(const K& key) const {
+      Node* temp = root;
+      Node* result = nullptr;
+      while(temp) {
+        if(less(temp->value.first,key)) {
+          temp = temp->rs;
+        } else {
+          result = temp;
+          temp = temp->ls;
+        }
+      }
+      return result;
+    }
+
+    // 第一个大于 key 的节点
+    template<class K>
+    Node* upper_node(const K& key) const {
+      Node* temp = root;
+      Node* result = nullptr;
+      while(temp) {
+        if(less(key,temp->value.first)) {
+          result = temp;
+          temp = temp->ls;
+        } else {
+          temp = temp->rs;
+        }
+      }
+      return result;
+    }
+
+    Node* select_node(size_t k) const requires Ranked {
+      Node* temp = root;
+      while(temp) {
+        size_t left = Node::count(temp->ls);
+        if(k < left) {
+          temp = temp->ls;
+        } else if(k == left) {
+          return temp;
+        } else {
+          k -= left+1;
+          temp = temp->rs;
+        }
+      }
+      return nullptr;
+    }
+
+    /**
+     * calls f on every element with lo <= key < hi, in order. Subtrees
+     * entirely outside the range are skipped, so this costs O(log n + k)
+     * and never climbs back up through parent pointers. Recursion only goes
+     * into left subtrees, at most the height of the tree.
+     */
+    template<class F>
+    void visit_range(Node* node, const Key& lo, const Key& hi, F& f) const {
+      while(node) {
+        if(less(node->value.first,lo)) {
+          node = node->rs;
+        } else if(!less(node->value.first,hi)) {
+          node = node->ls;
+        } else {
+          visit_range(node->ls,lo,hi,f);
+          f(node->value);
+          node = node->rs;
+        }
+      }
+    }
+
     Node* find_min() const{
       Node* temp = root;
       while (temp&&temp->ls) {
@@ -165,6 +473,9 @@ namespace sjtu {
     }
 
     Node* front() const{
+      if constexpr (Linked) {
+        return front_cache;
+      }
       if(is_dirty) {
         front_cache = find_min();
         last_cache = find_max();
@@ -174,6 +485,9 @@ namespace sjtu {
     }
 
     Node* last() const{
+      if constexpr (Linked) {
+        return last_cache;
+      }
       if(is_dirty) {
         front_cache = find_min();
         last_cache = find_max();
@@ -220,30 +534,47 @@ namespace sjtu {
       return node?node->height:0;
     }
 
-    //from oi.wiki
+    /**
+     * rebalances from node up after a child of node was added or removed.
+     * Walks up iteratively and stops rebalancing at the first subtree whose
+     * height is the same as before, nothing above it can be out of balance.
+     * A Ranked map still refreshes the subtree sizes up to the root.
+     * from oi.wiki
+     */
     void maintain(Node* node) {
-      //TODO
-      Node* parent = node->parent;
-      node->update_height();
-      Node* ls = node->ls;
-      Node* rs = node->rs;
-      if(h(ls)-h(rs)==2) {
-        if(h(ls->ls)>=h(ls->rs)) {
-          rotate_right(node);
-        } else {
-          rotate_left(ls);
-          rotate_right(node);
+      while(node) {
+        Node* parent = node->parent;
+        int old_height = node->height;
+        node->update_height();
+        Node* ls = node->ls;
+        Node* rs = node->rs;
+        Node* top = node;
+        if(h(ls)-h(rs)==2) {
+          if(h(ls->ls)>=h(ls->rs)) {
+            rotate_right(node);
+          } else {
+            rotate_left(ls);
+            rotate_right(node);
+          }
+          top = node->parent;
+        } else if(h(ls)-h(rs)==-2) {
+          if(h(rs->ls)<=h(rs->rs)) {
+            rotate_left(node);
+          } else {
+            rotate_right(rs);
+            rotate_left(node);
+          }
+          top = node->parent;
         }
-      } else if(h(ls)-h(rs)==-2) {
-        if(h(rs->ls)<=h(rs->rs)) {
-          rotate_left(node);
-        } else {
-          rotate_right(rs);
-          rotate_left(node);
+        if(top->height==old_height) {
+          if constexpr (Ranked) {
+            for(node = parent; node; node = node->parent) {
+              node->update_height(); // only the sizes still change
+            }
+          }
+          return;
         }
-      }
-      if(parent) {
-        maintain(parent);
+        node = parent;
       }
     }
 
@@ -262,6 +593,10 @@ namespace sjtu {
       std::swap(u->ls,v->ls);
       std::swap(u->rs,v->rs);
       std::swap(u->parent,v->parent);
+      std::swap(u->height,v->height); // heights belong to the positions
+      if constexpr (Ranked) {
+        std::swap(u->subtree,v->subtree);
+      }
       if(u->ls==u) {
         u->ls = v;
         v->parent = u;
@@ -305,6 +640,170 @@ namespace sjtu {
       }
     }
 
+    /**
+     * copies [first, last) into new nodes chained through rs, in input order.
+     * n counts them. sorted is cleared once a key is smaller than the one
+     * before it; while the input is sorted a key equal to the previous one
+     * is dropped, so the first one wins like with insert().
+     */
+    template<class InputIt>
+    Node* make_chain(InputIt first, InputIt last, size_t& n, bool& sorted) {
+      Node* head = nullptr;
+      Node* tail = nullptr;
+      n = 0;
+      sorted = true;
+      try {
+        for(; first != last; ++first) {
+          Node* temp = create_node(*first);
+          if(tail && sorted) {
+            if(less(temp->value.first,tail->value.first)) {
+              sorted = false;
+            } else if(!less(tail->value.first,temp->value.first)) {
+              destroy_node(temp);
+              continue;
+            }
+          }
+          (tail ? tail->rs : head) = temp;
+          tail = temp;
+          ++n;
+        }
+      } catch (...) {
+        destroy_chain(head);
+        throw;
+      }
+      return head;
+    }
+
+    void destroy_chain(Node* head) {
+      while(head) {
+        Node* next = head->rs;
+        destroy_node(head);
+        head = next;
+      }
+    }
+
+    // Unlinks every node, leaving them in key order chained through rs.
+    Node* flatten() {
+      Node* head = nullptr;
+      Node** tail = &head;
+      Node* node = root;
+      while(node) {
+        if(node->ls) {
+          Node* temp = node->ls;
+          node->ls = temp->rs;
+          temp->rs = node;
+          node = temp;
+        } else {
+          *tail = node;
+          tail = &node->rs;
+          node = node->rs;
+        }
+      }
+      root = nullptr;
+      return head;
+    }
+
+    /**
+     * merges the sorted chain b into the sorted chain a into head, a node
+     * of b with a key already in a is destroyed; n counts the result.
+     * If a comparison throws, the rest of b is destroyed and head holds
+     * what was merged so far followed by the rest of a, which is still
+     * sorted and counted in n, before the exception propagates.
+     */
+    void merge_chains(Node*& head, Node* a, Node* b, size_t& n) {
+      Node** tail = &head;
+      n = 0;
+      try {
+        while(a || b) {
+          Node* temp;
+          if(!b || (a && less(a->value.first,b->value.first))) {
+            temp = a;
+            a = a->rs;
+          } else if(!a || less(b->value.first,a->value.first)) {
+            temp = b;
+            b = b->rs;
+          } else {
+            Node* dup = b;
+            b = b->rs;
+            destroy_node(dup);
+            continue;
+          }
+          *tail = temp;
+          tail = &temp->rs;
+          ++n;
+        }
+      } catch (...) {
+        *tail = a;
+        for(; a; a = a->rs) {
+          ++n;
+        }
+        destroy_chain(b);
+        throw;
+      }
+      *tail = nullptr;
+    }
+
+    // Makes the sorted chain of n nodes the whole tree.
+    void rebuild_from_chain(Node* chain, size_t n) {
+      if constexpr (Linked) {
+        list_from_chain(chain);
+      }
+      root = build_balanced(chain, n, nullptr);
+      _size = n;
+    }
+
+    /**
+     * builds a balanced subtree out of the next n nodes of the chain and
+     * advances head past them. Sizes of sibling subtrees differ by at most
+     * one, so the result is a valid AVL tree; heights are set on the way up.
+     */
+    static Node* build_balanced(Node*& head, size_t n, Node* parent) {
+      if(n == 0) {
+        return nullptr;
+      }
+      size_t left = n / 2;
+      Node* ls = build_balanced(head, left, nullptr);
+      Node* node = head;
+      head = head->rs;
+      node->parent = parent;
+      node->ls = ls;
+      if(ls) {
+        ls->parent = node;
+      }
+      node->rs = build_balanced(head, n - 1 - left, node);
+      node->update_height();
+      return node;
+    }
+
+    // Builds a node from args at the free spot find_result found and rebalances.
+    template<class... Args>
+    Node* emplace_at(FindResult& find_result,Args&&... args) {
+      Node* temp = find_result.new_node(*this,std::forward<Args>(args)...);
+      maintain(temp->parent);
+      return temp;
+    }
+
+    // Inserts the chained nodes one by one, dropping those whose key exists.
+    void insert_chain(Node* head) {
+      try {
+        while(head) {
+          Node* temp = head;
+          auto find_result = find_unique(temp->value.first);
+          head = head->rs;
+          temp->rs = nullptr;
+          if(find_result.curr) {
+            destroy_node(temp);
+          } else {
+            find_result.link(temp,*this);
+            maintain(temp->parent);
+          }
+        }
+      } catch (...) {
+        destroy_chain(head);
+        throw;
+      }
+    }
+
   public:
 
     /**
@@ -542,6 +1041,14 @@ namespace sjtu {
       is_dirty = false;
     }
 
+    /**
+     * builds the map from a range sorted by key in O(n), see insert_sorted().
+     */
+    template<std::input_iterator InputIt>
+    map(InputIt first, InputIt last) : map() {
+      insert_sorted(first, last);
+    }
+
     map(const map &other) {
       if(!other.root) {
         _size = 0;
@@ -550,9 +1057,15 @@ namespace sjtu {
         is_dirty = false;
         return;
       }
-      _size = other._size;
-      root = other.root->copy();
+      root = nullptr;
       front_cache = last_cache = nullptr;
+      try {
+        copy_tree(other.root);
+      } catch (...) {
+        free_nodes();
+        throw;
+      }
+      _size = other._size;
       is_dirty = true;
     }
 
@@ -562,15 +1075,16 @@ namespace sjtu {
         std::swap(root, tmp.root);
         std::swap(_size, tmp._size);
         std::swap(cmp, tmp.cmp);
-        front_cache = last_cache = nullptr;
+        pool.swap(tmp.pool);
+        std::swap(front_cache, tmp.front_cache);
+        std::swap(last_cache, tmp.last_cache);
         is_dirty = true;
       }
       return *this;
     }
 
     ~map() {
-      delete root;
-
+      free_nodes();
     }
 
     /**
@@ -603,14 +1117,13 @@ namespace sjtu {
     T &operator[](const Key &key)
       requires std::is_default_constructible_v<T>
     {
-      auto find_result = find_unique(key);
-      Node* temp = find_result.curr;
-      if(!temp) {
-        temp = find_result.new_node({key,T()},*this);
-        maintain(temp);
-        is_dirty = true;
-      }
-      return temp->value.second;
+      return try_emplace(key).first->second;
+    }
+
+    T &operator[](Key &&key)
+      requires std::is_default_constructible_v<T>
+    {
+      return try_emplace(std::move(key)).first->second;
     }
 
     /**
@@ -663,7 +1176,7 @@ namespace sjtu {
      * clears the contents
      */
     void clear() {
-      delete root;
+      free_nodes();
       root = nullptr;
       _size = 0;
       front_cache = last_cache = nullptr;
@@ -681,12 +1194,125 @@ namespace sjtu {
       if(find_result.curr) {
         return {iterator(find_result.curr,this),false};
       }
-      is_dirty = true;
-      Node* temp = find_result.new_node(value,*this);
-      maintain(temp);
+      return {iterator(emplace_at(find_result,value),this),true};
+    }
+
+    // value is moved into the new node, and left alone if the key exists.
+    pair<iterator, bool> insert(value_type &&value) {
+      auto find_result = find_unique(value.first);
+      if(find_result.curr) {
+        return {iterator(find_result.curr,this),false};
+      }
+      return {iterator(emplace_at(find_result,std::move(value)),this),true};
+    }
+
+    /**
+     * constructs the element from args right in its node. The key is only
+     * known afterwards, so if it exists the new element is destroyed again;
+     * try_emplace avoids that when the key is at hand.
+     */
+    template<class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+      Node* temp = create_node(std::forward<Args>(args)...);
+      FindResult find_result;
+      try {
+        find_result = find_unique(temp->value.first);
+      } catch (...) {
+        destroy_node(temp);
+        throw;
+      }
+      if(find_result.curr) {
+        destroy_node(temp);
+        return {iterator(find_result.curr,this),false};
+      }
+      find_result.link(temp,*this);
+      maintain(temp->parent);
+      return {iterator(temp,this),true};
+    }
+
+    /**
+     * if key is absent, inserts (key, T(args...)) built in place; otherwise
+     * does nothing, and neither key nor args are moved from.
+     */
+    template<class... Args>
+    pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+      auto find_result = find_unique(key);
+      if(find_result.curr) {
+        return {iterator(find_result.curr,this),false};
+      }
+      Node* temp = emplace_at(find_result,std::piecewise_construct,std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+      return {iterator(temp,this),true};
+    }
+
+    template<class... Args>
+    pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+      auto find_result = find_unique(key);
+      if(find_result.curr) {
+        return {iterator(find_result.curr,this),false};
+      }
+      Node* temp = emplace_at(find_result,std::piecewise_construct,std::forward_as_tuple(std::move(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
       return {iterator(temp,this),true};
     }
 
+    /**
+     * assigns obj to the value of key, or inserts (key, obj) if key is absent.
+     * the second of the result is true if an element was inserted.
+     */
+    template<class M>
+    pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+      auto find_result = find_unique(key);
+      if(find_result.curr) {
+        find_result.curr->value.second = std::forward<M>(obj);
+        return {iterator(find_result.curr,this),false};
+      }
+      return {iterator(emplace_at(find_result,key,std::forward<M>(obj)),this),true};
+    }
+
+    template<class M>
+    pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+      auto find_result = find_unique(key);
+      if(find_result.curr) {
+        find_result.curr->value.second = std::forward<M>(obj);
+        return {iterator(find_result.curr,this),false};
+      }
+      return {iterator(emplace_at(find_result,std::move(key),std::forward<M>(obj)),this),true};
+    }
+
+    /**
+     * inserts a range sorted by key. The new nodes are merged with the
+     * existing ones and the whole tree is rebuilt perfectly balanced in
+     * O(size() + n), which beats n single inserts unless the range is small
+     * compared to the map. If the range turns out not to be sorted its
+     * elements are inserted one by one instead. Like insert(), a key that
+     * is already present keeps its old value; iterators stay valid.
+     * If Compare throws, the map keeps its old elements and some of the new.
+     */
+    template<std::input_iterator InputIt>
+    void insert_sorted(InputIt first, InputIt last) {
+      size_t n;
+      bool sorted;
+      Node* chain = make_chain(first, last, n, sorted);
+      if(!chain) {
+        return;
+      }
+      is_dirty = true;
+      if(!sorted || n * 16 < _size) {
+        insert_chain(chain);
+        return;
+      }
+      Node* merged = nullptr;
+      size_t count = 0;
+      try {
+        merge_chains(merged, flatten(), chain, count);
+      } catch (...) {
+        rebuild_from_chain(merged, count);
+        throw;
+      }
+      rebuild_from_chain(merged, count);
+    }
+
     /**
      * erase the element at pos.
      *
@@ -705,14 +1331,17 @@ namespace sjtu {
       if(temp->ls||temp->rs) {
         temp->ls?swap(temp,temp->ls):swap(temp,temp->rs);
       }
+      if constexpr (Linked) {
+        list_erase(temp);
+      }
       if(temp==root) {
         root = nullptr;
-        delete temp;
+        destroy_node(temp);
         return;
       }
       auto temp_parent = temp->parent;
       (temp_parent->ls==temp?temp_parent->ls:temp_parent->rs) = nullptr;
-      delete temp;
+      destroy_node(temp);
       maintain(temp_parent);
     }
 
@@ -742,6 +1371,177 @@ namespace sjtu {
       auto result = find_unique(key);
       return const_iterator((result.curr),this);
     }
+
+    /**
+     * order statistics, only for Ranked maps, all O(log n).
+     * rank(key) is the number of keys less than key.
+     */
+    size_t rank(const Key &key) const requires Ranked {
+      size_t result = 0;
+      Node* temp = root;
+      while(temp) {
+        if(less(temp->value.first,key)) {
+          result += Node::count(temp->ls)+1;
+          temp = temp->rs;
+        } else {
+          temp = temp->ls;
+        }
+      }
+      return result;
+    }
+
+    /**
+     * the element with exactly k smaller keys (k counts from 0),
+     * end() if k >= size().
+     */
+    iterator select(size_t k) requires Ranked {
+      return iterator(select_node(k),this);
+    }
+
+    const_iterator select(size_t k) const requires Ranked {
+      return const_iterator(select_node(k),this);
+    }
+
+    /**
+     * the position of it in key order, size() for end().
+     * throw invalid_iterator if it does not belong to this map.
+     */
+    size_t index(const const_iterator &it) const requires Ranked {
+      if(it.map_ptr != this) {
+        throw invalid_iterator();
+      }
+      Node* temp = it.ptr;
+      if(!temp) {
+        return _size;
+      }
+      size_t result = Node::count(temp->ls);
+      for(; temp->parent; temp = temp->parent) {
+        if(temp->parent->rs == temp) {
+          result += Node::count(temp->parent->ls)+1;
+        }
+      }
+      return result;
+    }
+
+    // the number of ++ that take first to last, negative if last comes first.
+    std::ptrdiff_t distance(const const_iterator &first, const const_iterator &last) const requires Ranked {
+      return static_cast<std::ptrdiff_t>(index(last)) - static_cast<std::ptrdiff_t>(index(first));
+    }
+
+    /**
+     * Returns an iterator to the first element whose key is not less than
+     * key, or end() if there is none.
+     */
+    iterator lower_bound(const Key &key) {
+      return iterator(lower_node(key),this);
+    }
+
+    const_iterator lower_bound(const Key &key) const {
+      return const_iterator(lower_node(key),this);
+    }
+
+    /**
+     * Returns an iterator to the first element whose key is greater than
+     * key, or end() if there is none.
+     */
+    iterator upper_bound(const Key &key) {
+      return iterator(upper_node(key),this);
+    }
+
+    const_iterator upper_bound(const Key &key) const {
+      return const_iterator(upper_node(key),this);
+    }
+
+    /**
+     * Returns [lower_bound(key), upper_bound(key)), which holds at most one
+     * element since keys are unique.
+     */
+    pair<iterator, iterator> equal_range(const Key &key) {
+      return {lower_bound(key),upper_bound(key)};
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+      return {lower_bound(key),upper_bound(key)};
+    }
+
+    /**
+     * calls f(value_type&) on every element with lo <= key < hi, in key
+     * order, in O(log n + k). f must not insert into or erase from the map.
+     */
+    template<class F>
+    void for_each_in_range(const Key &lo, const Key &hi, F f) {
+      visit_range(root,lo,hi,f);
+    }
+
+    template<class F>
+    void for_each_in_range(const Key &lo, const Key &hi, F f) const {
+      auto visit = [&f](const value_type &value) { f(value); };
+      visit_range(root,lo,hi,visit);
+    }
+
+    /**
+     * returns an immutable copy of the elements in Eytzinger layout, whose
+     * find, count and bounds are faster than the tree's on large maps.
+     * The copy does not follow later changes of the map.
+     */
+    frozen_map<Key, T, Compare> freeze() const {
+      return frozen_map<Key, T, Compare>(cbegin(),_size,cmp);
+    }
+
+    /**
+     * heterogeneous count, find, lower_bound, upper_bound and equal_range,
+     * only if Compare is transparent (has
+     * is_transparent, like std::less<>). key may be anything Compare can put
+     * next to a Key, e.g. a const char* or std::string_view for std::string
+     * keys, and no temporary Key is constructed. Other arguments go to the
+     * plain overloads.
+     */
+    template<class K> requires comparable_with<K>
+    size_t count(const K &key) const {
+      return find_unique(key).curr!=nullptr;
+    }
+
+    template<class K> requires comparable_with<K>
+    iterator find(const K &key) {
+      auto result = find_unique(key);
+      return iterator((result.curr),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    const_iterator find(const K &key) const {
+      auto result = find_unique(key);
+      return const_iterator((result.curr),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    iterator lower_bound(const K &key) {
+      return iterator(lower_node(key),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    const_iterator lower_bound(const K &key) const {
+      return const_iterator(lower_node(key),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    iterator upper_bound(const K &key) {
+      return iterator(upper_node(key),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    const_iterator upper_bound(const K &key) const {
+      return const_iterator(upper_node(key),this);
+    }
+
+    template<class K> requires comparable_with<K>
+    pair<iterator, iterator> equal_range(const K &key) {
+      return {lower_bound(key),upper_bound(key)};
+    }
+
+    template<class K> requires comparable_with<K>
+    pair<const_iterator, const_iterator> equal_range(const K &key) const {
+      return {lower_bound(key),upper_bound(key)};
+    }
   };
 }
 
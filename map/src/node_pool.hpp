@@ -0,0 +1,93 @@
+#ifndef SJTU_NODE_POOL_HPP
+#define SJTU_NODE_POOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+  /**
+   * raw storage for objects of type T, carved out of slabs.
+   * A freed slot goes on a free list and is handed out again first, so
+   * allocate and deallocate are O(1) and neighbouring nodes share cache lines.
+   * Slabs go back to the system all at once in release() or the destructor.
+   * The pool never runs a destructor, its owner destroys the objects first.
+   */
+  template<typename T>
+  class node_pool {
+    union Slot {
+      Slot* next;
+      alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr size_t FIRST_SLAB = 32;   // slots in the first slab
+    static constexpr size_t MAX_SLAB = 4096;   // slabs stop doubling here
+
+    Slot* slabs = nullptr;      // the first slot of every slab links to the next slab
+    Slot* free_list = nullptr;
+    Slot* bump = nullptr;       // unused tail of the newest slab
+    Slot* bump_end = nullptr;
+    size_t next_slab = FIRST_SLAB;
+
+    void new_slab() {
+      Slot* slab = static_cast<Slot*>(::operator new(sizeof(Slot) * (next_slab + 1),
+                                                     std::align_val_t(alignof(Slot))));
+      slab->next = slabs;
+      slabs = slab;
+      bump = slab + 1;
+      bump_end = slab + 1 + next_slab;
+      if (next_slab < MAX_SLAB) {
+        next_slab *= 2;
+      }
+    }
+
+  public:
+    node_pool() = default;
+
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    ~node_pool() {
+      release();
+    }
+
+    void* allocate() {
+      if (free_list) {
+        Slot* slot = free_list;
+        free_list = slot->next;
+        return slot;
+      }
+      if (bump == bump_end) {
+        new_slab();
+      }
+      return bump++;
+    }
+
+    void deallocate(void* p) {
+      Slot* slot = static_cast<Slot*>(p);
+      slot->next = free_list;
+      free_list = slot;
+    }
+
+    // Frees every slab, all storage handed out so far becomes invalid.
+    void release() {
+      while (slabs) {
+        Slot* next = slabs->next;
+        ::operator delete(slabs, std::align_val_t(alignof(Slot)));
+        slabs = next;
+      }
+      free_list = bump = bump_end = nullptr;
+      next_slab = FIRST_SLAB;
+    }
+
+    void swap(node_pool& other) noexcept {
+      std::swap(slabs, other.slabs);
+      std::swap(free_list, other.free_list);
+      std::swap(bump, other.bump);
+      std::swap(bump_end, other.bump_end);
+      std::swap(next_slab, other.next_slab);
+    }
+  };
+}
+
+#endif
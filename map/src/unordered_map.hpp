@@ -0,0 +1,637 @@
+/**
+ * a hash map with open addressing and the interface of sjtu::map
+ */
+#ifndef SJTU_UNORDERED_MAP_HPP
+#define SJTU_UNORDERED_MAP_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+  /**
+   * 16 control bytes of a hash table, one per slot:
+   *   0..127  the slot is full, the byte is 7 bits of the element's hash
+   *   EMPTY   the slot was never used since the last rehash
+   *   DELETED the slot held an element that was erased (a tombstone)
+   * Every match returns a bit mask, bit i stands for byte i.
+   * With SSE2 one compare handles all 16 bytes.
+   */
+  class ctrl_group {
+  public:
+    static constexpr int SIZE = 16;
+    static constexpr signed char EMPTY = -128;
+    static constexpr signed char DELETED = -2;
+
+#if defined(__SSE2__)
+    explicit ctrl_group(const signed char* ctrl)
+      : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {
+    }
+
+    unsigned match(signed char h2) const {
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes));
+    }
+
+    // EMPTY and DELETED are the bytes with the sign bit set
+    unsigned match_free() const {
+      return _mm_movemask_epi8(bytes);
+    }
+
+  private:
+    __m128i bytes;
+#else
+    explicit ctrl_group(const signed char* ctrl) {
+      memcpy(bytes, ctrl, SIZE);
+    }
+
+    unsigned match(signed char h2) const {
+      unsigned mask = 0;
+      for(int i = 0; i < SIZE; ++i) {
+        mask |= unsigned(bytes[i] == h2) << i;
+      }
+      return mask;
+    }
+
+    unsigned match_free() const {
+      unsigned mask = 0;
+      for(int i = 0; i < SIZE; ++i) {
+        mask |= unsigned(bytes[i] < 0) << i;
+      }
+      return mask;
+    }
+
+  private:
+    signed char bytes[SIZE];
+#endif
+
+  public:
+    unsigned match_empty() const {
+      return match(EMPTY);
+    }
+
+    unsigned match_full() const {
+      return ~match_free() & 0xffff;
+    }
+  };
+
+  /**
+   * an unordered map for lookups that never need key order.
+   * The elements sit in one array of slots, a second array holds one
+   * control byte per slot (see ctrl_group). A key's hash picks the slot to
+   * start at and 7 more bits of it; a lookup compares those 7 bits against
+   * 16 control bytes at once and only calls Equal on the hits, then moves
+   * on to the next group of 16 (quadratic probing) until it meets an empty
+   * slot. The table grows to twice its size once it is 7/8 full.
+   *
+   * insert may rehash and then invalidates every iterator and reference.
+   * erase only invalidates the erased element.
+   */
+  template<
+    class Key,
+    class T,
+    class Hash = std::hash<Key>,
+    class Equal = std::equal_to<Key> >
+  class unordered_map {
+  public:
+    typedef pair<const Key, T> value_type;
+
+  private:
+    static constexpr int GROUP = ctrl_group::SIZE;
+    static constexpr size_t MIN_CAPACITY = GROUP;
+
+    /**
+     * ctrl[0, capacity) are the control bytes, followed by a copy of the
+     * first GROUP of them, so a group can be loaded at any slot without
+     * wrapping around. capacity is 0 or a power of two >= GROUP.
+     */
+    signed char* ctrl;
+    value_type* slots;
+    size_t capacity;
+    size_t _size;
+    size_t growth_left;  // inserts into EMPTY slots until the next rehash
+    Hash hasher;
+    Equal eq;
+
+    static size_t max_load(size_t capacity) {
+      return capacity - capacity / 8;
+    }
+
+    // std::hash is the identity for integers, mix so that all bits matter
+    size_t hash_of(const Key &key) const {
+      size_t h = hasher(key);
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    static signed char h2_of(size_t hash) {
+      return static_cast<signed char>(hash & 0x7f);
+    }
+
+    void set_ctrl(size_t i, signed char h) {
+      ctrl[i] = h;
+      if(i < GROUP) {
+        ctrl[capacity + i] = h;
+      }
+    }
+
+    // where the probe for hash starts, every step moves one group further
+    size_t probe_start(size_t hash) const {
+      return (hash >> 7) & (capacity - 1);
+    }
+
+    // the slot holding key, capacity if there is none
+    size_t find_index(const Key &key) const {
+      if(_size == 0) {
+        return capacity;
+      }
+      size_t hash = hash_of(key);
+      size_t mask = capacity - 1;
+      size_t pos = probe_start(hash);
+      for(size_t step = GROUP; ; step += GROUP) {
+        ctrl_group group(ctrl + pos);
+        for(unsigned hits = group.match(h2_of(hash)); hits; hits &= hits - 1) {
+          size_t i = (pos + __builtin_ctz(hits)) & mask;
+          if(eq(slots[i].first, key)) {
+            return i;
+          }
+        }
+        if(group.match_empty()) {
+          return capacity;
+        }
+        pos = (pos + step) & mask;
+      }
+    }
+
+    // the first EMPTY or DELETED slot on the probe of hash
+    size_t find_free(size_t hash) const {
+      size_t mask = capacity - 1;
+      size_t pos = probe_start(hash);
+      for(size_t step = GROUP; ; step += GROUP) {
+        unsigned free = ctrl_group(ctrl + pos).match_free();
+        if(free) {
+          return (pos + __builtin_ctz(free)) & mask;
+        }
+        pos = (pos + step) & mask;
+      }
+    }
+
+    // the first full slot at or after i, capacity if there is none
+    size_t next_full(size_t i) const {
+      while(i < capacity) {
+        unsigned full = ctrl_group(ctrl + i).match_full();
+        if(full) {
+          i += __builtin_ctz(full);
+          return i < capacity ? i : capacity;
+        }
+        i += GROUP;
+      }
+      return capacity;
+    }
+
+    static signed char* allocate_ctrl(size_t capacity) {
+      signed char* bytes = static_cast<signed char*>(::operator new(capacity + GROUP));
+      memset(bytes, ctrl_group::EMPTY, capacity + GROUP);
+      return bytes;
+    }
+
+    static value_type* allocate_slots(size_t capacity) {
+      return static_cast<value_type*>(::operator new(capacity * sizeof(value_type), std::align_val_t(alignof(value_type))));
+    }
+
+    static void deallocate(signed char* ctrl, value_type* slots) {
+      if(ctrl) {
+        ::operator delete(ctrl);
+        ::operator delete(slots, std::align_val_t(alignof(value_type)));
+      }
+    }
+
+    // destroys the elements in the full slots of [0, end)
+    void destroy_elements(size_t end) {
+      if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        for(size_t i = next_full(0); i < end; i = next_full(i + 1)) {
+          slots[i].~value_type();
+        }
+      }
+    }
+
+    /**
+     * moves every element into a new table of new_capacity slots, which
+     * also drops all tombstones. If moving an element may throw, the
+     * elements are copied instead and the old table stays as it was.
+     */
+    void rehash(size_t new_capacity) {
+      signed char* new_ctrl = allocate_ctrl(new_capacity);
+      value_type* new_slots;
+      try {
+        new_slots = allocate_slots(new_capacity);
+      } catch (...) {
+        ::operator delete(new_ctrl);
+        throw;
+      }
+      unordered_map fresh;
+      fresh.ctrl = new_ctrl;
+      fresh.slots = new_slots;
+      fresh.capacity = new_capacity;
+      fresh.hasher = hasher;
+      fresh.eq = eq;
+      for(size_t i = next_full(0); i < capacity; i = next_full(i + 1)) {
+        size_t hash = hash_of(slots[i].first);
+        size_t j = fresh.find_free(hash);
+        new (fresh.slots + j) value_type(std::move_if_noexcept(slots[i]));
+        fresh.set_ctrl(j, h2_of(hash));
+        ++fresh._size;
+      }
+      fresh.growth_left = max_load(new_capacity) - _size;
+      swap(fresh);
+    }
+
+    // makes sure one more element fits into an EMPTY slot
+    void reserve_one() {
+      if(growth_left > 0) {
+        return;
+      }
+      if(capacity == 0) {
+        rehash(MIN_CAPACITY);
+      } else if(_size <= max_load(capacity) / 2) {
+        rehash(capacity);  // mostly tombstones
+      } else {
+        rehash(capacity * 2);
+      }
+    }
+
+    /**
+     * builds (key, value) from args in a free slot for key, which must not
+     * be in the map. Returns the slot.
+     */
+    template<class... Args>
+    size_t insert_new(const Key &key, Args&&... args) {
+      reserve_one();
+      size_t hash = hash_of(key);
+      size_t i = find_free(hash);
+      new (slots + i) value_type(std::forward<Args>(args)...);
+      if(ctrl[i] == ctrl_group::EMPTY) {
+        --growth_left;
+      }
+      set_ctrl(i, h2_of(hash));
+      ++_size;
+      return i;
+    }
+
+    /**
+     * a slot can become EMPTY again if no probe ever had to pass it, i.e.
+     * every window of GROUP slots around it has an EMPTY one. Otherwise it
+     * becomes a tombstone so that probes keep going.
+     */
+    void erase_index(size_t i) {
+      slots[i].~value_type();
+      --_size;
+      size_t mask = capacity - 1;
+      unsigned empty_after = ctrl_group(ctrl + i).match_empty();
+      unsigned empty_before = ctrl_group(ctrl + ((i - GROUP) & mask)).match_empty();
+      if(empty_before && empty_after
+         && __builtin_ctz(empty_after) + (__builtin_clz(empty_before) - 16) < GROUP) {
+        set_ctrl(i, ctrl_group::EMPTY);
+        ++growth_left;
+      } else {
+        set_ctrl(i, ctrl_group::DELETED);
+      }
+    }
+
+  public:
+    /**
+     * a forward iterator: ++end() and dereferencing end() throw
+     * invalid_iterator. The order of the elements is unspecified.
+     */
+    class const_iterator;
+
+    class iterator {
+    private:
+      unordered_map* map_ptr = nullptr;
+      size_t index = 0;
+      friend const_iterator;
+      friend unordered_map;
+
+      iterator(unordered_map* map_ptr, size_t index): map_ptr(map_ptr), index(index) {
+      }
+
+    public:
+      iterator() = default;
+
+      iterator &operator++() {
+        if(!map_ptr || index >= map_ptr->capacity) {
+          throw invalid_iterator();
+        }
+        index = map_ptr->next_full(index + 1);
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      value_type &operator*() const {
+        if(!map_ptr || index >= map_ptr->capacity) {
+          throw invalid_iterator();
+        }
+        return map_ptr->slots[index];
+      }
+
+      value_type *operator->() const noexcept {
+        return map_ptr->slots + index;
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    class const_iterator {
+    private:
+      const unordered_map* map_ptr = nullptr;
+      size_t index = 0;
+      friend iterator;
+      friend unordered_map;
+
+      const_iterator(const unordered_map* map_ptr, size_t index): map_ptr(map_ptr), index(index) {
+      }
+
+    public:
+      const_iterator() = default;
+
+      const_iterator(const iterator &other): map_ptr(other.map_ptr), index(other.index) {
+      }
+
+      const_iterator &operator++() {
+        if(!map_ptr || index >= map_ptr->capacity) {
+          throw invalid_iterator();
+        }
+        index = map_ptr->next_full(index + 1);
+        return *this;
+      }
+
+      const_iterator operator++(int) {
+        const_iterator temp = *this;
+        ++*this;
+        return temp;
+      }
+
+      const value_type &operator*() const {
+        if(!map_ptr || index >= map_ptr->capacity) {
+          throw invalid_iterator();
+        }
+        return map_ptr->slots[index];
+      }
+
+      const value_type *operator->() const noexcept {
+        return map_ptr->slots + index;
+      }
+
+      bool operator==(const iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator==(const const_iterator &rhs) const {
+        return index == rhs.index && map_ptr == rhs.map_ptr;
+      }
+
+      bool operator!=(const iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+      bool operator!=(const const_iterator &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    unordered_map(): ctrl(nullptr), slots(nullptr), capacity(0), _size(0), growth_left(0) {
+    }
+
+    // same capacity and layout as other, each element is copied into its slot
+    unordered_map(const unordered_map &other): unordered_map() {
+      hasher = other.hasher;
+      eq = other.eq;
+      if(other.capacity == 0) {
+        return;
+      }
+      ctrl = allocate_ctrl(other.capacity);
+      try {
+        slots = allocate_slots(other.capacity);
+      } catch (...) {
+        ::operator delete(ctrl);
+        ctrl = nullptr;
+        throw;
+      }
+      capacity = other.capacity;
+      size_t i = other.next_full(0);
+      try {
+        for(; i < capacity; i = other.next_full(i + 1)) {
+          new (slots + i) value_type(other.slots[i]);
+          ctrl[i] = other.ctrl[i];
+        }
+      } catch (...) {
+        destroy_elements(i);
+        deallocate(ctrl, slots);
+        throw;
+      }
+      memcpy(ctrl, other.ctrl, capacity + GROUP);
+      _size = other._size;
+      growth_left = other.growth_left;
+    }
+
+    unordered_map &operator=(const unordered_map &other) {
+      if(this != &other) {
+        unordered_map tmp(other);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+    ~unordered_map() {
+      destroy_elements(capacity);
+      deallocate(ctrl, slots);
+    }
+
+    void swap(unordered_map &other) {
+      std::swap(ctrl, other.ctrl);
+      std::swap(slots, other.slots);
+      std::swap(capacity, other.capacity);
+      std::swap(_size, other._size);
+      std::swap(growth_left, other.growth_left);
+      std::swap(hasher, other.hasher);
+      std::swap(eq, other.eq);
+    }
+
+    /**
+     * access specified element with bounds checking,
+     * throw index_out_of_bound if key does not exist.
+     */
+    T &at(const Key &key) {
+      size_t i = find_index(key);
+      if(i == capacity) {
+        throw index_out_of_bound();
+      }
+      return slots[i].second;
+    }
+
+    const T &at(const Key &key) const {
+      size_t i = find_index(key);
+      if(i == capacity) {
+        throw index_out_of_bound();
+      }
+      return slots[i].second;
+    }
+
+    /**
+     * returns the value mapped to key, inserting T() if key does not exist.
+     */
+    T &operator[](const Key &key)
+      requires std::is_default_constructible_v<T>
+    {
+      return try_emplace(key).first->second;
+    }
+
+    // behave like at()
+    const T &operator[](const Key &key) const {
+      return at(key);
+    }
+
+    iterator begin() {
+      return iterator(this, next_full(0));
+    }
+
+    const_iterator cbegin() const {
+      return const_iterator(this, next_full(0));
+    }
+
+    iterator end() {
+      return iterator(this, capacity);
+    }
+
+    const_iterator cend() const {
+      return const_iterator(this, capacity);
+    }
+
+    bool empty() const {
+      return _size == 0;
+    }
+
+    size_t size() const {
+      return _size;
+    }
+
+    // destroys every element, the table keeps its capacity
+    void clear() {
+      destroy_elements(capacity);
+      if(ctrl) {
+        memset(ctrl, ctrl_group::EMPTY, capacity + GROUP);
+      }
+      _size = 0;
+      growth_left = capacity ? max_load(capacity) : 0;
+    }
+
+    /**
+     * makes room for n elements, so that inserting up to n of them does
+     * not rehash.
+     */
+    void reserve(size_t n) {
+      size_t want = MIN_CAPACITY;
+      while(max_load(want) < n) {
+        want *= 2;
+      }
+      if(want > capacity) {
+        rehash(want);
+      }
+    }
+
+    /**
+     * insert an element.
+     * return the iterator to the new element (or the one that prevented the
+     * insertion) and whether the insertion took place.
+     */
+    pair<iterator, bool> insert(const value_type &value) {
+      size_t i = find_index(value.first);
+      if(i != capacity) {
+        return {iterator(this, i), false};
+      }
+      return {iterator(this, insert_new(value.first, value)), true};
+    }
+
+    pair<iterator, bool> insert(value_type &&value) {
+      size_t i = find_index(value.first);
+      if(i != capacity) {
+        return {iterator(this, i), false};
+      }
+      return {iterator(this, insert_new(value.first, std::move(value))), true};
+    }
+
+    /**
+     * if key is absent, inserts (key, T(args...)) built in place.
+     */
+    template<class... Args>
+    pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+      size_t i = find_index(key);
+      if(i != capacity) {
+        return {iterator(this, i), false};
+      }
+      return {iterator(this, insert_new(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                        std::forward_as_tuple(std::forward<Args>(args)...))), true};
+    }
+
+    /**
+     * erase the element at pos.
+     * throw invalid_iterator if pos is end() or belongs to another map.
+     */
+    void erase(iterator pos) {
+      if(pos.map_ptr != this || pos.index >= capacity || ctrl[pos.index] < 0) {
+        throw invalid_iterator();
+      }
+      erase_index(pos.index);
+    }
+
+    /**
+     * Returns the number of elements with key, either 1 or 0.
+     */
+    size_t count(const Key &key) const {
+      return find_index(key) != capacity;
+    }
+
+    /**
+     * Finds an element with key equivalent to key, end() if there is none.
+     */
+    iterator find(const Key &key) {
+      return iterator(this, find_index(key));
+    }
+
+    const_iterator find(const Key &key) const {
+      return const_iterator(this, find_index(key));
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "vector.hpp"
+
+#include <cstdio>
+
+// owns a heap buffer like Util::Bint and counts how often it gets copied
+struct Tracked {
+	static int copies;
+	static int alive;
+	int *id;
+
+	Tracked(int id) : id(new int(id)) {
+		++alive;
+	}
+	Tracked(const Tracked &rhs) : id(new int(*rhs.id)) {
+		++copies;
+		++alive;
+	}
+	Tracked(Tracked &&rhs) noexcept : id(rhs.id) {
+		rhs.id = nullptr;
+		++alive;
+	}
+	~Tracked() {
+		delete id;
+		--alive;
+	}
+};
+
+int Tracked::copies = 0;
+int Tracked::alive = 0;
+
+void print(const sjtu::vector<Tracked> &v) {
+	for (size_t i = 0; i < v.size(); ++i) {
+		printf("%d ", *v[i].id);
+	}
+	puts("");
+}
+
+void test_push_and_emplace() {
+	sjtu::vector<Tracked> v;
+	for (int i = 0; i < 5; ++i) {
+		v.push_back(Tracked(i));
+	}
+	for (int i = 5; i < 10; ++i) {
+		v.emplace_back(i);
+	}
+	Tracked &last = v.emplace_back(42);
+	printf("%d\n", *last.id);
+	v.emplace(v.begin(), -1);
+	v.emplace(3, 300);
+	v.insert(v.begin() + 1, Tracked(100));
+	v.emplace(v.size(), 99);
+	print(v);
+	printf("copies: %d\n", Tracked::copies);
+}
+
+void test_self_reference() {
+	sjtu::vector<Tracked> v;
+	v.emplace_back(7);
+	for (int i = 0; i < 40; ++i) {
+		v.push_back(v[0]);
+		v.insert(v.begin(), v[v.size() - 1]);
+		v.emplace(v.begin() + 1, v[0]);
+	}
+	int sum = 0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum += *v[i].id;
+	}
+	printf("%d %d\n", (int)v.size(), sum);
+}
+
+void test_move_vector() {
+	sjtu::vector<Tracked> a;
+	for (int i = 0; i < 100; ++i) {
+		a.emplace_back(i);
+	}
+	Tracked::copies = 0;
+	sjtu::vector<Tracked> b(std::move(a));
+	printf("%d %d %d\n", (int)a.size(), (int)b.size(), *b[99].id);
+	sjtu::vector<Tracked> c;
+	c.emplace_back(0);
+	c = std::move(b);
+	printf("%d %d %d\n", (int)b.size(), (int)c.size(), *c[50].id);
+	a = std::move(c);
+	a.push_back(Tracked(100));
+	printf("%d %d\n", (int)a.size(), *a.back().id);
+	printf("copies: %d\n", Tracked::copies);
+}
+
+int main() {
+	test_push_and_emplace();
+	test_self_reference();
+	test_move_vector();
+	printf("alive: %d\n", Tracked::alive);
+	return 0;
+}
@@ -0,0 +1,88 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+template<class Alloc>
+long long fill_and_sum(sjtu::vector<long long, Alloc> &v, int n) {
+	for (int i = 0; i < n; ++i) {
+		v.push_back(i);
+	}
+	v.erase(v.begin());
+	v.insert(v.begin() + 10, 1000000LL);
+	long long sum = 0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum += v[i];
+	}
+	return sum;
+}
+
+void test_malloc() {
+	sjtu::vector<long long, sjtu::malloc_allocator> v;
+	printf("malloc %lld\n", fill_and_sum(v, 100000));
+	sjtu::vector<long long, sjtu::malloc_allocator> w(v);
+	v.clear();
+	v.shrink_to_fit();
+	printf("%d %d %lld\n", (int)v.capacity(), (int)w.size(), w[10]);
+
+	sjtu::vector<Util::Bint, sjtu::malloc_allocator> b;
+	for (int i = 0; i < 100; ++i) {
+		b.push_back(Util::Bint(i) * i * i);
+	}
+	std::cout << b[99] << std::endl;
+}
+
+void test_arena() {
+	alignas(16) static char buffer[1 << 16];
+	sjtu::monotonic_arena arena(buffer, sizeof(buffer));
+	sjtu::arena_allocator alloc(arena);
+	{
+		sjtu::vector<long long, sjtu::arena_allocator> v(alloc);
+		printf("arena %lld\n", fill_and_sum(v, 1000));
+		printf("%d\n", (int)(arena.used() >= 1024 * sizeof(long long)));
+		sjtu::vector<long long, sjtu::arena_allocator> w(alloc);
+		w.reserve(100);
+		for (int i = 0; i < 100; ++i) {
+			w.push_back(i);
+		}
+		printf("%lld %d\n", w.back(), (int)(v.capacity() == 1024));
+		sjtu::vector<long long, sjtu::arena_allocator> moved(std::move(w));
+		printf("%d %lld\n", (int)moved.size(), moved[50]);
+		try {
+			v.reserve(1 << 20);
+		} catch (sjtu::std_bad_alloc &) {
+			printf("arena exhausted\n");
+		}
+		printf("%d %lld\n", (int)v.size(), v[10]);
+	}
+	arena.release();
+	printf("%d\n", (int)arena.used());
+}
+
+void test_adaptive() {
+	// 1 KiB threshold, so small vectors use malloc and big ones mmap
+	sjtu::vector<long long, sjtu::adaptive_allocator<1024>> v;
+	printf("adaptive %lld\n", fill_and_sum(v, 100000));
+	v.resize(10);
+	v.shrink_to_fit();
+	printf("%d %lld\n", (int)v.capacity(), v[9]);
+	sjtu::vector<long long, sjtu::adaptive_allocator<1024>> huge(
+		sjtu::map_policy::huge_pages);
+	printf("%lld\n", fill_and_sum(huge, 1 << 20));
+
+	sjtu::small_vector<long long, 4, sjtu::malloc_allocator> s;
+	for (int i = 0; i < 10; ++i) {
+		s.push_back(i);
+	}
+	s.resize(2);
+	s.shrink_to_fit();
+	printf("%d %lld\n", (int)s.capacity(), s[1]);
+}
+
+int main() {
+	test_malloc();
+	test_arena();
+	test_adaptive();
+	return 0;
+}
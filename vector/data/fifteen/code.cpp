@@ -0,0 +1,81 @@
+#define SJTU_VECTOR_CHECKED 2
+#include "vector.hpp"
+
+#include <cstdio>
+
+template<typename F>
+void expect_stale(const char *what, F f) {
+	try {
+		f();
+		printf("%s: ok\n", what);
+	} catch (sjtu::invalid_iterator &) {
+		printf("%s: stale\n", what);
+	}
+}
+
+void test_growth() {
+	sjtu::vector<int> v;
+	v.reserve(4);
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(i);
+	}
+	auto it = v.begin() + 1;
+	sjtu::vector<int>::const_iterator cit = v.cbegin();
+	v[3] = 30; // No reallocation, iterators stay valid
+	v.insert(v.end() - 1, 7);  // Grows past the reserved 4
+	expect_stale("deref after growth", [&] { printf("%d\n", *it); });
+	expect_stale("increment after growth", [&] { ++cit; });
+	expect_stale("insert at stale", [&] { v.insert(it, 5); });
+	expect_stale("erase at stale", [&] { v.erase(it); });
+	sjtu::vector<int>::const_iterator converted = it;
+	expect_stale("converted stale", [&] { printf("%d\n", *converted); });
+	expect_stale("distance to stale", [&] { printf("%d\n", (int)(v.end() - it)); });
+	expect_stale("distance from stale", [&] { printf("%d\n", (int)(cit - v.cbegin())); });
+	it = v.begin() + 1;
+	expect_stale("refreshed", [&] { printf("%d %d\n", *it, it[3]); });
+}
+
+void test_reserved() {
+	sjtu::vector<long long> v;
+	v.reserve(1000);
+	auto first = v.begin();
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(i);
+	}
+	expect_stale("within capacity", [&] { printf("%lld %lld\n", *first, first[999]); });
+	v.erase(v.begin() + 10, v.end());
+	expect_stale("after erase", [&] { printf("%lld\n", first[9]); });
+	v.shrink_to_fit();
+	expect_stale("after shrink_to_fit", [&] { printf("%lld\n", *first); });
+}
+
+void test_moves() {
+	sjtu::vector<int> a;
+	for (int i = 0; i < 100; ++i) {
+		a.push_back(i);
+	}
+	auto it = a.begin() + 50;
+	sjtu::vector<int> b(std::move(a));
+	expect_stale("moved from", [&] { printf("%d\n", *it); });
+	auto jt = b.begin();
+	b.clear();
+	for (int i = 0; i < 3; ++i) {
+		b.push_back(i);
+	}
+	expect_stale("after clear", [&] { printf("%d\n", *jt); });
+
+	sjtu::small_vector<int, 4> s;
+	s.push_back(1);
+	auto st = s.begin();
+	for (int i = 0; i < 4; ++i) {
+		s.push_back(i);
+	}
+	expect_stale("spilled small_vector", [&] { printf("%d\n", *st); });
+}
+
+int main() {
+	test_growth();
+	test_reserved();
+	test_moves();
+	return 0;
+}
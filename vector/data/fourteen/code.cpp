@@ -0,0 +1,78 @@
+#define SJTU_VECTOR_CHECKED 1
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <numeric>
+
+static_assert(std::contiguous_iterator<sjtu::vector<int>::iterator>);
+static_assert(std::contiguous_iterator<sjtu::vector<int>::const_iterator>);
+
+void test_data() {
+	sjtu::vector<int> v;
+	printf("%d\n", v.data() == nullptr);
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(i * i);
+	}
+	int *p = v.data();
+	long long sum = 0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		sum += p[i];
+	}
+	printf("%lld %d %d\n", sum, &*v.begin() == p, std::to_address(v.end()) == p + 10);
+	const sjtu::vector<int> &c = v;
+	printf("%d\n", c.data()[9]);
+}
+
+void test_arithmetic() {
+	sjtu::vector<int> v;
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(99 - i);
+	}
+	std::sort(v.begin(), v.end());
+	printf("%d %d %d\n", v[0], v[50], v[99]);
+	auto it = v.begin() + 10;
+	printf("%d %d %d %d\n", it[5], *(2 + it), (int)(v.end() - it), (int)(it - v.begin()));
+	sjtu::vector<int>::const_iterator cit = it;
+	printf("%d %d %d\n", cit == it, it != v.cbegin(), v.cbegin() < cit);
+	printf("%d\n", std::accumulate(v.cbegin(), v.cend(), 0));
+	printf("%d\n", (int)(std::lower_bound(v.begin(), v.end(), 42) - v.begin()));
+}
+
+void test_checks() {
+	sjtu::vector<int> a, b;
+	for (int i = 0; i < 5; ++i) {
+		a.push_back(i);
+		b.push_back(i);
+	}
+	try {
+		a.insert(b.begin(), 7);
+	} catch (sjtu::invalid_iterator &) {
+		printf("foreign iterator\n");
+	}
+	try {
+		printf("%d\n", (int)(a.end() - b.begin()));
+	} catch (sjtu::invalid_iterator &) {
+		printf("mixed difference\n");
+	}
+	try {
+		printf("%d\n", *a.end());
+	} catch (sjtu::index_out_of_bound &) {
+		printf("deref end\n");
+	}
+	try {
+		sjtu::vector<int>::iterator lonely;
+		++lonely;
+	} catch (sjtu::invalid_iterator &) {
+		printf("unattached\n");
+	}
+	printf("%d\n", a.begin() == b.begin());
+}
+
+int main() {
+	test_data();
+	test_arithmetic();
+	test_checks();
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdio>
+
+void test_reserve() {
+	sjtu::vector<long long> v;
+	v.reserve(1000000);
+	printf("%d %d\n", (int)v.size(), (int)v.capacity());
+	v.push_back(0);
+	const long long *first = &v[0];
+	for (long long i = 1; i < 1000000; ++i) {
+		v.push_back(i);
+	}
+	printf("%s\n", first == &v[0] ? "not moved" : "moved");
+	printf("%d %lld\n", (int)v.capacity(), v.back());
+	v.reserve(10);
+	printf("%d\n", (int)v.capacity());
+}
+
+void test_resize() {
+	sjtu::vector<int> v;
+	v.resize(5);
+	for (size_t i = 0; i < v.size(); ++i) {
+		printf("%d ", v[i]);
+	}
+	puts("");
+	v.resize(8, 7);
+	v.resize(6);
+	for (size_t i = 0; i < v.size(); ++i) {
+		printf("%d ", v[i]);
+	}
+	puts("");
+	v.resize(100, v[5]);
+	printf("%d %d %d\n", (int)v.size(), v[99], v[5]);
+	v.resize(0);
+	printf("%d %d\n", (int)v.size(), (int)v.empty());
+}
+
+void test_shrink() {
+	sjtu::vector<Util::Bint> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(Util::Bint(i) * i);
+	}
+	printf("%d\n", (int)v.capacity());
+	v.resize(10);
+	v.shrink_to_fit();
+	printf("%d %d\n", (int)v.size(), (int)v.capacity());
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << ' ';
+	}
+	std::cout << std::endl;
+	v.push_back(Util::Bint(12345));
+	std::cout << v.back() << ' ' << v.capacity() << std::endl;
+	v.clear();
+	v.shrink_to_fit();
+	printf("%d %d\n", (int)v.size(), (int)v.capacity());
+	v.resize(3, Util::Bint(9));
+	std::cout << v[0] << v[1] << v[2] << std::endl;
+}
+
+int main() {
+	test_reserve();
+	test_resize();
+	test_shrink();
+	return 0;
+}
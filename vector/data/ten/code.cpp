@@ -0,0 +1,85 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <type_traits>
+
+// a plain vector only ever steals a block, so containers of vectors can move them
+static_assert(std::is_nothrow_move_constructible_v<sjtu::vector<Util::Bint>>);
+static_assert(std::is_nothrow_move_assignable_v<sjtu::vector<Util::Bint>>);
+
+template<typename T, size_t N>
+const char *where(const sjtu::small_vector<T, N> &v) {
+	const char *begin = reinterpret_cast<const char *>(&v);
+	const char *first = reinterpret_cast<const char *>(&v[0]);
+	return (first >= begin && first < begin + sizeof(v)) ? "inline" : "mapped";
+}
+
+void test_inline() {
+	sjtu::small_vector<int, 4> v;
+	printf("%d %d\n", (int)v.size(), (int)v.capacity());
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(i);
+	}
+	printf("%s %d\n", where(v), (int)v.capacity());
+	v.push_back(4);
+	printf("%s %d\n", where(v), (int)v.capacity());
+	for (int i = 5; i < 100; ++i) {
+		v.insert(v.begin(), i);
+	}
+	v.resize(3);
+	v.shrink_to_fit();
+	printf("%s %d %d %d %d\n", where(v), (int)v.capacity(), v[0], v[1], v[2]);
+	v.clear();
+	v.push_back(42);
+	printf("%s %d\n", where(v), v.back());
+}
+
+void test_copy_move() {
+	sjtu::small_vector<Util::Bint, 3> a;
+	for (int i = 1; i <= 3; ++i) {
+		a.push_back(Util::Bint(i) * 1000000007);
+	}
+	sjtu::small_vector<Util::Bint, 3> b(a);
+	sjtu::small_vector<Util::Bint, 3> c(std::move(a));
+	std::cout << where(b) << ' ' << where(c) << ' ' << a.size() << std::endl;
+	for (size_t i = 0; i < c.size(); ++i) {
+		std::cout << b[i] << ' ' << c[i] << std::endl;
+	}
+	c.push_back(Util::Bint(4));
+	b = c;
+	std::cout << where(b) << ' ' << b.size() << ' ' << b.back() << std::endl;
+	b = std::move(c);
+	std::cout << where(b) << ' ' << b.size() << ' ' << c.size() << std::endl;
+
+	// small and plain vectors convert both ways
+	sjtu::vector<Util::Bint> plain(b);
+	sjtu::vector<Util::Bint> stolen(std::move(b));
+	std::cout << plain.size() << ' ' << stolen.size() << ' ' << b.size() << std::endl;
+	sjtu::small_vector<Util::Bint, 3> back_in(stolen);
+	sjtu::small_vector<Util::Bint, 8> moved_in(std::move(stolen));
+	std::cout << where(back_in) << ' ' << where(moved_in) << ' ' << moved_in[3] << std::endl;
+	sjtu::small_vector<Util::Bint, 3> d;
+	d.push_back(Util::Bint(5));
+	plain = std::move(d);
+	std::cout << plain.size() << ' ' << plain[0] << ' ' << d.size() << std::endl;
+	sjtu::small_vector<Util::Bint, 3> empty;
+	sjtu::vector<Util::Bint> from_empty(std::move(empty));
+	std::cout << from_empty.size() << ' ' << from_empty.capacity() << ' ' << empty.size() << std::endl;
+}
+
+void test_through_base(sjtu::vector<int> &v) {
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(i * i);
+	}
+}
+
+int main() {
+	test_inline();
+	test_copy_move();
+	sjtu::small_vector<int, 16> v;
+	test_through_base(v);
+	printf("%s %d %d\n", where(v), (int)v.size(), v[9]);
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+template<typename T>
+void print(const sjtu::vector<T> &v) {
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << ' ';
+	}
+	std::cout << std::endl;
+}
+
+void test_front_batches() {
+	// like data/two, but every batch of 2048 goes in with one shift
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 1LL << 20; ++i) {
+		v.push_back(i);
+	}
+	sjtu::vector<long long> batch;
+	for (long long i = 0; i < 1LL << 11; ++i) {
+		batch.push_back(i);
+	}
+	for (int round = 0; round < 8; ++round) {
+		v.insert(v.begin(), batch.begin(), batch.end());
+	}
+	printf("%d %lld %lld %lld\n", (int)v.size(), v[0], v[2047], v[8 * 2048]);
+	v.erase(v.begin(), v.begin() + 8 * 2048 - 1);
+	printf("%d %lld %lld %lld\n", (int)v.size(), v[0], v[1], v.back());
+}
+
+void test_small_ranges() {
+	sjtu::vector<int> v;
+	int raw[] = {1, 2, 3, 4, 5};
+	v.assign(raw, raw + 5);
+	print(v);
+	v.insert(v.begin() + 2, 3, 0);
+	print(v);
+	v.insert(v.end(), raw, raw + 2);
+	v.insert(v.begin(), raw + 4, raw + 5);
+	print(v);
+	v.insert(v.begin() + 1, 2, v[0]);
+	print(v);
+	v.erase(v.begin() + 3, v.begin() + 6);
+	print(v);
+	v.erase(v.begin(), v.begin());
+	v.insert(v.begin() + 4, raw, raw);
+	print(v);
+	v.erase(v.begin(), v.end());
+	printf("%d\n", (int)v.size());
+	v.assign(4, 9);
+	print(v);
+	try {
+		v.erase(v.begin() + 3, v.begin() + 1);
+	} catch (...) {
+		printf("bad range\n");
+	}
+}
+
+void test_input_iterator() {
+	std::istringstream in("10 20 30 40");
+	sjtu::vector<std::string> v;
+	v.assign(3, std::string("x"));
+	v.insert(v.begin() + 1, std::istream_iterator<std::string>(in),
+	         std::istream_iterator<std::string>());
+	print(v);
+	std::istringstream again("a b");
+	v.assign(std::istream_iterator<std::string>(again),
+	         std::istream_iterator<std::string>());
+	print(v);
+}
+
+void test_bint() {
+	sjtu::vector<Util::Bint> a;
+	for (int i = 0; i < 10; ++i) {
+		a.push_back(Util::Bint(i) * 1000000007);
+	}
+	sjtu::vector<Util::Bint> b;
+	b.assign(a.cbegin(), a.cend());
+	b.insert(b.begin() + 5, a.begin(), a.begin() + 3);
+	b.insert(b.begin(), 2, Util::Bint(-1));
+	b.erase(b.begin() + 10, b.end());
+	print(b);
+}
+
+int main() {
+	test_front_batches();
+	test_small_ranges();
+	test_input_iterator();
+	test_bint();
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// points into itself, so it must never be moved bitwise
+struct SelfRef {
+	int value;
+	int *self;
+
+	SelfRef(int value) : value(value), self(&this->value) {}
+	SelfRef(const SelfRef &rhs) : value(rhs.value), self(&value) {}
+	SelfRef &operator=(const SelfRef &rhs) = delete;
+
+	bool ok() const {
+		return self == &value;
+	}
+};
+
+// counts moves; it is fine to move bitwise and says so below
+struct Counted {
+	static int moves;
+	int *value;
+
+	Counted(int value) : value(new int(value)) {}
+	Counted(const Counted &rhs) : value(new int(*rhs.value)) {}
+	Counted(Counted &&rhs) noexcept : value(rhs.value) {
+		rhs.value = nullptr;
+		++moves;
+	}
+	~Counted() {
+		delete value;
+	}
+};
+
+int Counted::moves = 0;
+
+template<>
+struct sjtu::is_trivially_relocatable<Counted> : std::true_type {};
+
+template<>
+struct sjtu::is_trivially_relocatable<Util::Bint> : std::true_type {};
+
+void test_self_ref() {
+	sjtu::vector<SelfRef> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(SelfRef(i));
+	}
+	for (int i = 0; i < 100; ++i) {
+		v.insert(v.begin() + i * 3, SelfRef(-i));
+		v.erase(v.begin() + i * 5);
+	}
+	v.shrink_to_fit();
+	bool ok = true;
+	long long sum = 0;
+	for (size_t i = 0; i < v.size(); ++i) {
+		ok = ok && v[i].ok();
+		sum += v[i].value;
+	}
+	sjtu::vector<SelfRef> w(v);
+	sjtu::vector<SelfRef> moved(std::move(w));
+	for (size_t i = 0; i < moved.size(); ++i) {
+		ok = ok && moved[i].ok();
+	}
+	printf("%d %lld %s\n", (int)v.size(), sum, ok ? "ok" : "broken");
+
+	sjtu::small_vector<SelfRef, 4> small;
+	for (int i = 0; i < 6; ++i) {
+		small.push_back(SelfRef(i));
+	}
+	small.resize(3, SelfRef(0));
+	small.shrink_to_fit();
+	sjtu::small_vector<SelfRef, 4> other(std::move(small));
+	printf("%d %d %d\n", (int)other.size(),
+	       (int)(other[0].ok() && other[1].ok() && other[2].ok()), other[2].value);
+}
+
+void test_strings() {
+	sjtu::vector<std::string> v;
+	for (int i = 0; i < 500; ++i) {
+		v.push_back(std::to_string(i));
+	}
+	for (int i = 0; i < 50; ++i) {
+		v.insert(v.begin(), std::string("front") + std::to_string(i));
+		v.erase(v.begin() + 100);
+	}
+	v.emplace(v.begin() + 7, 5, 'x');
+	std::string all;
+	for (size_t i = 0; i < v.size(); i += 50) {
+		all += v[i] + ",";
+	}
+	std::cout << v.size() << ' ' << v[7] << ' ' << all << std::endl;
+}
+
+void test_opt_in() {
+	sjtu::vector<Counted> v;
+	for (int i = 0; i < 100000; ++i) {
+		v.emplace_back(i);
+	}
+	v.insert(v.begin(), Counted(-1));
+	v.erase(v.begin() + 10);
+	printf("moves: %d %d %d\n", Counted::moves, *v[0].value, *v[10].value);
+
+	sjtu::vector<Util::Bint> b;
+	for (int i = 0; i < 1000; ++i) {
+		b.push_back(Util::Bint(i) * i);
+	}
+	b.insert(b.begin(), Util::Bint(7));
+	std::cout << b[0] << ' ' << b[1000] << std::endl;
+}
+
+int main() {
+	test_self_ref();
+	test_strings();
+	test_opt_in();
+	return 0;
+}
@@ -0,0 +1,358 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // For mremap
+#endif
+#include <sys/mman.h> // For mmap, munmap, mremap, madvise
+#include <unistd.h>   // For sysconf, _SC_PAGESIZE
+#include <cstddef>    // For size_t, std::max_align_t
+#include <cstdint>    // For uintptr_t
+#include <cstdio>     // For perror
+#include <cstdlib>    // For malloc, realloc, free
+#include <cstring>    // For memcpy
+
+namespace sjtu {
+
+  /**
+   * Allocators hand raw bytes to vector. Every allocator provides
+   *   static constexpr size_t alignment;   // guaranteed alignment of blocks
+   *   size_t good_size(size_t bytes) const;  // bytes actually worth asking for
+   *   void *allocate(size_t bytes);
+   *   void *reallocate(void *p, size_t old_bytes, size_t new_bytes);
+   *   void deallocate(void *p, size_t bytes);
+   * allocate and reallocate return nullptr on failure and leave p untouched.
+   * reallocate moves the old contents bitwise, like mremap and realloc do.
+   * bytes is never 0, and deallocate/reallocate get the size that was
+   * returned by good_size() when the block was allocated.
+   */
+
+  /**
+   * how an mmap_allocator asks the kernel for its mapping, flags can be combined with |.
+   * huge_pages: mappings of at least 2 MiB are rounded up and aligned to 2 MiB
+   *   and marked MADV_HUGEPAGE, so transparent huge pages can back them.
+   * populate: pages are prefaulted when they are mapped (MAP_POPULATE),
+   *   so the first pass over a fresh buffer takes no page faults.
+   */
+  enum class map_policy : unsigned {
+    none = 0,
+    huge_pages = 1,
+    populate = 2,
+  };
+
+  inline constexpr map_policy operator|(map_policy a, map_policy b) {
+    return static_cast<map_policy>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+  }
+
+  inline constexpr bool operator&(map_policy a, map_policy b) {
+    return (static_cast<unsigned>(a) & static_cast<unsigned>(b)) != 0;
+  }
+
+  /**
+   * every block is its own anonymous mapping, grown and shrunk with mremap.
+   * No copy is needed when a block grows, which makes it the best choice for
+   * big buffers. It is the default allocator of vector.
+   */
+  class mmap_allocator {
+  public:
+    static constexpr size_t alignment = 4096;
+    static constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20; // PMD size on x86-64
+
+    mmap_allocator() : policy(map_policy::none) {}
+
+    explicit mmap_allocator(map_policy policy) : policy(policy) {}
+
+    map_policy get_policy() const {
+      return policy;
+    }
+
+    // With huge pages the size is rounded up to whole huge pages.
+    size_t good_size(size_t bytes) const {
+      if (use_huge_pages(bytes)) {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+      }
+      return bytes;
+    }
+
+    void *allocate(size_t bytes) const {
+      void *region = map_region(bytes);
+      if (region == MAP_FAILED) return nullptr;
+      apply_policy(region, 0, bytes);
+      return region;
+    }
+
+    void *reallocate(void *p, size_t old_bytes, size_t new_bytes) const {
+      void *region;
+      if (use_huge_pages(new_bytes) && new_bytes > old_bytes) {
+        // Grow in place if we are aligned already and the kernel can,
+        // otherwise move into an aligned region
+        region = MAP_FAILED;
+        if (reinterpret_cast<uintptr_t>(p) % HUGE_PAGE_SIZE == 0) {
+          region = mremap(p, old_bytes, new_bytes, 0);
+        }
+        if (region == MAP_FAILED) {
+          void *target = map_region(new_bytes);
+          if (target != MAP_FAILED) {
+            region = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (region == MAP_FAILED) munmap(target, new_bytes);
+          }
+        }
+      } else {
+        region = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+      }
+      if (region == MAP_FAILED) return nullptr; // Old mapping is still valid
+      if (new_bytes > old_bytes) {
+        apply_policy(region, old_bytes, new_bytes);
+      }
+      return region;
+    }
+
+    void deallocate(void *p, size_t bytes) const {
+      if (munmap(p, bytes) == -1) {
+        perror("munmap failed in mmap_allocator");
+      }
+    }
+
+  private:
+    map_policy policy;
+
+    bool use_huge_pages(size_t bytes) const {
+      return (policy & map_policy::huge_pages) && bytes >= HUGE_PAGE_SIZE;
+    }
+
+    /**
+     * mmap a fresh region of bytes. For huge pages we map one extra huge page
+     * and cut the unaligned head and tail away, so the region starts on a
+     * 2 MiB boundary.
+     */
+    void *map_region(size_t bytes) const {
+      int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+      if (!use_huge_pages(bytes)) {
+        if (policy & map_policy::populate) flags |= MAP_POPULATE;
+        return mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+      }
+      size_t span = bytes + HUGE_PAGE_SIZE;
+      void *raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, flags, -1, 0);
+      if (raw == MAP_FAILED) return MAP_FAILED;
+      uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+      uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+      size_t head = aligned - begin;
+      size_t tail = span - head - bytes;
+      if (head > 0) munmap(raw, head);
+      if (tail > 0) munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+      return reinterpret_cast<void *>(aligned);
+    }
+
+    /**
+     * applies the policy to [from, to) of a region that was just mapped or
+     * grown. madvise has to come before the prefault, otherwise the range is
+     * already backed by small pages.
+     */
+    void apply_policy(void *region, size_t from, size_t to) const {
+      if (use_huge_pages(to)) {
+        madvise(region, to, MADV_HUGEPAGE); // Only a hint, failure is fine
+        if (policy & map_policy::populate) {
+          populate_range(static_cast<char *>(region) + from, to - from);
+        }
+      } else if ((policy & map_policy::populate) && from > 0) {
+        populate_range(static_cast<char *>(region) + from, to - from); // Grown by mremap
+      }
+    }
+
+    static void populate_range(char *begin, size_t bytes) {
+#ifdef MADV_POPULATE_WRITE
+      if (madvise(begin, bytes, MADV_POPULATE_WRITE) == 0) return;
+#endif
+      // Older kernels: touch one byte per page, the memory is still unused
+      long page_size = sysconf(_SC_PAGESIZE);
+      if (page_size <= 0) page_size = 4096; // Fallback page size
+      for (size_t offset = 0; offset < bytes; offset += page_size) {
+        static_cast<volatile char *>(begin)[offset] = 0;
+      }
+    }
+  };
+
+  /**
+   * plain malloc/realloc/free. glibc serves small and medium blocks from its
+   * heap without a syscall, so this is cheaper than mmap for short vectors.
+   */
+  class malloc_allocator {
+  public:
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    size_t good_size(size_t bytes) const {
+      return bytes;
+    }
+
+    void *allocate(size_t bytes) const {
+      return malloc(bytes);
+    }
+
+    void *reallocate(void *p, size_t, size_t new_bytes) const {
+      return realloc(p, new_bytes);
+    }
+
+    void deallocate(void *p, size_t) const {
+      free(p);
+    }
+  };
+
+  /**
+   * a bump allocator over a buffer supplied by the caller, who keeps it alive
+   * longer than every vector using it. Memory is only given back by release()
+   * (or when the last block is freed or shrunk), so a vector that grows
+   * inside an arena should be reserve()d up front.
+   * Once the buffer is used up allocations fail and vector throws
+   * std_bad_alloc.
+   */
+  class monotonic_arena {
+  public:
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    monotonic_arena(void *buffer, size_t bytes)
+        : begin(static_cast<char *>(buffer)), cur(begin), end(begin + bytes), last(nullptr) {
+      cur = align_up(cur);
+      if (cur > end) cur = end;
+    }
+
+    monotonic_arena(const monotonic_arena &) = delete;
+    monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+    void *allocate(size_t bytes) {
+      if (bytes > static_cast<size_t>(end - cur)) return nullptr;
+      last = cur;
+      cur = align_up(cur + bytes);
+      if (cur > end) cur = end;
+      return last;
+    }
+
+    // The most recent block grows or shrinks in place, others are copied.
+    void *reallocate(void *p, size_t old_bytes, size_t new_bytes) {
+      if (p == last) {
+        if (new_bytes > static_cast<size_t>(end - last)) return nullptr;
+        cur = align_up(last + new_bytes);
+        if (cur > end) cur = end;
+        return p;
+      }
+      void *block = allocate(new_bytes);
+      if (block) {
+        memcpy(block, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+      }
+      return block;
+    }
+
+    // Only the most recent block can be handed back.
+    void deallocate(void *p, size_t) {
+      if (p == last) {
+        cur = last;
+        last = nullptr;
+      }
+    }
+
+    // Forgets every block at once, the caller must not use them anymore.
+    void release() {
+      cur = align_up(begin);
+      if (cur > end) cur = end;
+      last = nullptr;
+    }
+
+    size_t used() const {
+      return cur - begin;
+    }
+
+    size_t remaining() const {
+      return end - cur;
+    }
+
+  private:
+    char *begin;
+    char *cur;
+    char *end;
+    char *last; // Start of the most recent block
+
+    static char *align_up(char *p) {
+      uintptr_t value = reinterpret_cast<uintptr_t>(p);
+      return p + ((alignment - value % alignment) % alignment);
+    }
+  };
+
+  // The allocator handle a vector stores, it just points at the arena.
+  class arena_allocator {
+  public:
+    static constexpr size_t alignment = monotonic_arena::alignment;
+
+    explicit arena_allocator(monotonic_arena &arena) : arena(&arena) {}
+
+    size_t good_size(size_t bytes) const {
+      return bytes;
+    }
+
+    void *allocate(size_t bytes) const {
+      return arena->allocate(bytes);
+    }
+
+    void *reallocate(void *p, size_t old_bytes, size_t new_bytes) const {
+      return arena->reallocate(p, old_bytes, new_bytes);
+    }
+
+    void deallocate(void *p, size_t bytes) const {
+      arena->deallocate(p, bytes);
+    }
+
+  private:
+    monotonic_arena *arena;
+  };
+
+  /**
+   * malloc below Threshold bytes, mmap from there on. Which one owns a block
+   * only depends on its size, so a block moves over (with one copy) when a
+   * reallocate crosses the threshold. The default mirrors glibc's own
+   * M_MMAP_THRESHOLD.
+   */
+  template<size_t Threshold = 128 * 1024>
+  class adaptive_allocator {
+  public:
+    static constexpr size_t alignment = malloc_allocator::alignment;
+
+    adaptive_allocator() = default;
+
+    // The policy is only used for the blocks that go to mmap.
+    explicit adaptive_allocator(map_policy policy) : large(policy) {}
+
+    size_t good_size(size_t bytes) const {
+      return is_large(bytes) ? large.good_size(bytes) : small.good_size(bytes);
+    }
+
+    void *allocate(size_t bytes) const {
+      return is_large(bytes) ? large.allocate(bytes) : small.allocate(bytes);
+    }
+
+    void *reallocate(void *p, size_t old_bytes, size_t new_bytes) const {
+      if (is_large(old_bytes) == is_large(new_bytes)) {
+        return is_large(new_bytes) ? large.reallocate(p, old_bytes, new_bytes)
+                                   : small.reallocate(p, old_bytes, new_bytes);
+      }
+      void *block = allocate(new_bytes);
+      if (block) {
+        memcpy(block, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(p, old_bytes);
+      }
+      return block;
+    }
+
+    void deallocate(void *p, size_t bytes) const {
+      is_large(bytes) ? large.deallocate(p, bytes) : small.deallocate(p, bytes);
+    }
+
+  private:
+    [[no_unique_address]] malloc_allocator small;
+    mmap_allocator large;
+
+    static bool is_large(size_t bytes) {
+      return bytes >= Threshold;
+    }
+  };
+
+}  // namespace sjtu
+
+#endif
@@ -1,177 +1,402 @@
 #ifndef SJTU_VECTOR_HPP
 #define SJTU_VECTOR_HPP
 
-#define _GNU_SOURCE // For mremap
-#include <sys/mman.h> // For mmap, munmap, mremap, MAP_FAILED, PROT_READ, PROT_WRITE, MAP_PRIVATE, MAP_ANONYMOUS
-#include <unistd.h>   // For sysconf, _SC_PAGESIZE
 #include <cstddef>    // For size_t
-#include <cstring>    // For memmove (memcpy is not directly used by us for full copies anymore)
-#include <cstdio>     // For perror (though we prefer exceptions)
-#include <cstdlib>    // For exit (though we prefer exceptions)
+#include <cstring>    // For memmove, memcpy
+#include <iterator>   // For std::forward_iterator, std::distance
 #include <new>        // For std::bad_alloc, placement new
+#include <type_traits> // For std::is_constructible_v, std::is_trivially_copyable
+#include <utility>    // For std::move, std::forward, std::move_if_noexcept
 
+#include <compare>    // For operator<=> on iterators
+
+#include "allocator.hpp"  // mmap_allocator (the default), malloc_allocator, arena_allocator, ...
 #include "exceptions.hpp" // Should define sjtu::std_bad_alloc, index_out_of_bound, etc.
 
 #include <climits>
-#include <iostream> // For debugging, can be removed
+
+/**
+ * SJTU_VECTOR_CHECKED picks the iterator checking policy:
+ *   1 - iterators remember their vector; moving an unattached iterator,
+ *       mixing vectors or dereferencing outside [begin(), end()) throws.
+ *   2 - like 1, and every vector counts how often its buffer was replaced
+ *       (any capacity change, being moved from). Iterators record the count
+ *       they were made at; using one from before a reallocation throws
+ *       invalid_iterator, even when mremap happened to keep the address.
+ *       Opt-in, it makes vector and iterator one word larger.
+ *   0 - iterators are plain pointers and nothing is checked.
+ * Debug builds default to 1, builds with NDEBUG to 0. Define it before
+ * including vector.hpp to choose yourself.
+ */
+#ifndef SJTU_VECTOR_CHECKED
+#ifdef NDEBUG
+#define SJTU_VECTOR_CHECKED 0
+#else
+#define SJTU_VECTOR_CHECKED 1
+#endif
+#endif
 
 namespace sjtu {
 
   class std_bad_alloc : public exception {
     /* __________________________ */
   };
+
+  /**
+   * tells vector that a T may be moved to another address bitwise (memmove,
+   * mremap, realloc) instead of move-constructing it there and destroying the
+   * original. True for trivially copyable types; other types can opt in when
+   * no pointer refers into the object itself, e.g.
+   *   template<> struct sjtu::is_trivially_relocatable<Util::Bint> : std::true_type {};
+   * libstdc++'s std::string must not opt in: a short string points into itself.
+   */
+  template<typename T>
+  struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+  template<typename T>
+  inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+  template<typename T, size_t N, class Alloc = mmap_allocator>
+  class small_vector;
+
   /**
    * a data container like std::vector
    * store data in a successive memory and support random access.
+   * Memory comes from Alloc (see allocator.hpp), by default one mmap per vector.
    */
-  template<typename T>
+  template<typename T, class Alloc = mmap_allocator>
   class vector {
+    static_assert(alignof(T) <= Alloc::alignment, "Alloc cannot align T");
+
   private:
-    T *data;
+    T *_data;
     // int capacity; // Replaced by capacity_bytes
     size_t capacity_bytes; // Stores capacity in bytes
     size_t _size;          // Changed from int to size_t
+    [[no_unique_address]] Alloc alloc;
+    unsigned inline_capacity; // Elements that fit in inline_data, see small_vector
+    T *inline_data;           // Buffer owned by a small_vector, nullptr otherwise
+#if SJTU_VECTOR_CHECKED >= 2
+    size_t generation = 0;    // Bumped whenever the buffer is replaced
+#endif
 
     static constexpr int SIZE = sizeof(T); // Kept as int, though size_t would be more idiomatic for sizeof
     static constexpr int DEFAULT_SIZE_ELEMENTS = 16; // Renamed for clarity, original DEFAULT_SIZE
     static constexpr float EXPAND_RATE = 2.0f; // Made float literal explicit
-    // static constexpr float SHRINK_RATE = 0.25f; // Kept commented
+    static constexpr bool RELOCATABLE = is_trivially_relocatable_v<T>;
 
-    void free_resource() {
-      if (data) {
-        for (size_t i = 0; i < _size; ++i) {
-          data[i].~T();
-        }
-        if (capacity_bytes > 0) {
-          if (munmap(data, capacity_bytes) == -1) {
-            perror("munmap failed in free_resource"); // Or throw a runtime_error
+    bool is_inline() const {
+      return inline_data != nullptr && _data == inline_data;
+    }
+
+    // Makes every iterator handed out so far stale (SJTU_VECTOR_CHECKED >= 2).
+    void retire_iterators() {
+#if SJTU_VECTOR_CHECKED >= 2
+      ++generation;
+#endif
+    }
+
+    // Points _data back at the inline buffer, or at nothing for a plain vector.
+    void reset_storage() {
+      retire_iterators();
+      _data = inline_data;
+      capacity_bytes = inline_data ? static_cast<size_t>(inline_capacity) * SIZE : 0;
+    }
+
+    /**
+     * moves n elements from src to the separate buffer dst. Trivially
+     * relocatable types are copied bitwise. Other types are moved (copied if
+     * their move may throw) and the old ones are only destroyed once all new
+     * ones exist, so a throw leaves src as it was.
+     */
+    static void relocate(T *dst, T *src, size_t n) {
+      if constexpr (RELOCATABLE) {
+        memcpy(static_cast<void*>(dst), static_cast<void*>(src), n * SIZE);
+      } else {
+        size_t i = 0;
+        try {
+          for (; i < n; ++i) {
+            new (dst + i) T(std::move_if_noexcept(src[i]));
+          }
+        } catch (...) {
+          for (size_t j = 0; j < i; ++j) {
+            dst[j].~T();
           }
+          throw;
+        }
+        for (i = 0; i < n; ++i) {
+          src[i].~T();
         }
-        data = nullptr;
-        _size = 0;
-        capacity_bytes = 0;
-      }
-    }
-
-    void check_expand() {
-        size_t current_element_capacity = (capacity_bytes > 0 && SIZE > 0) ? (capacity_bytes / SIZE) : 0;
-
-        // _size is already incremented before check_expand is called in push_back/insert.
-        // So, we expand if the new _size exceeds the old element capacity.
-        if (_size > current_element_capacity) {
-            size_t old_capacity_bytes = capacity_bytes;
-            size_t new_element_capacity;
-
-            if (current_element_capacity == 0) { // Initial allocation
-                new_element_capacity = DEFAULT_SIZE_ELEMENTS;
-                if (new_element_capacity == 0) new_element_capacity = 1; // Ensure at least 1 element
-            } else { // Expanding existing allocation
-                new_element_capacity = static_cast<size_t>(EXPAND_RATE * current_element_capacity);
-                if (new_element_capacity < _size) { // Must be able to hold current number of elements
-                    new_element_capacity = _size;
-                }
-                // Ensure actual growth if _size didn't force it significantly or EXPAND_RATE is <= 1
-                if (new_element_capacity <= current_element_capacity && _size > current_element_capacity) {
-                     new_element_capacity = current_element_capacity + 1; // Minimal growth to accommodate _size
-                } else if (new_element_capacity <= current_element_capacity) {
-                     new_element_capacity = current_element_capacity +1; // Ensure growth if _size didn't force it
-                }
+      }
+    }
 
+    /**
+     * moves [ind, _size) up by count slots, leaving [ind, ind + count) raw;
+     * _size is not changed. If a move constructor throws, the elements from
+     * the failing one on are dropped (_size shrinks) so the vector stays valid.
+     */
+    void shift_up(size_t ind, size_t count) {
+      if constexpr (RELOCATABLE) {
+        memmove(static_cast<void*>(_data + ind + count), static_cast<void*>(_data + ind), (_size - ind) * SIZE);
+      } else {
+        for (size_t i = _size; i > ind; --i) {
+          try {
+            new (_data + i - 1 + count) T(std::move(_data[i - 1]));
+          } catch (...) {
+            for (size_t j = i + count; j < _size + count; ++j) {
+              _data[j].~T();
             }
+            _size = i;
+            throw;
+          }
+          _data[i - 1].~T();
+        }
+      }
+    }
 
-            size_t new_capacity_bytes = new_element_capacity * SIZE;
-            if (new_capacity_bytes == 0 && new_element_capacity > 0 && SIZE == 0) {
-                // Handle T being an empty struct (sizeof(T) can be 1, but if it were 0 by some compiler extension)
-                // mmap with size 0 is invalid. Let's ensure a minimal byte allocation if elements > 0.
-                // Standard C++: sizeof empty class is at least 1. So SIZE > 0.
-                // This case is mostly theoretical for standard C++.
-            }
-             if (new_capacity_bytes == 0 && new_element_capacity > 0) { // e.g. T is empty struct, SIZE might be 1
-                // If we intend to store elements, we need some bytes.
-                // Page size is a common minimum for mmap, but mmap can do smaller.
-                // For simplicity, if new_element_capacity > 0 but new_capacity_bytes is 0 (e.g. SIZE=0),
-                // this is an issue. However, sizeof(T) >= 1.
-                // So, if new_element_capacity > 0, then new_capacity_bytes will be > 0.
-             }
-
-
-            void* new_data_ptr = nullptr;
-
-            if (old_capacity_bytes == 0) { // Initial mmap
-                if (new_capacity_bytes == 0) { // Cannot mmap 0 bytes if we intend to store elements
-                    if (new_element_capacity > 0) { // We want space but calculated 0 bytes
-                         // This should ideally not happen if new_element_capacity >= 1 and SIZE >=1
-                         // If it does, force a minimal byte allocation, e.g., page size or SIZE.
-                         long page_size = sysconf(_SC_PAGESIZE);
-                         if (page_size <=0) page_size = 4096; // Fallback page size
-                         new_capacity_bytes = (SIZE > 0) ? (new_element_capacity * SIZE) : (size_t)page_size;
-                         if (new_capacity_bytes == 0) new_capacity_bytes = (size_t)page_size; // Absolute fallback
-                    } else {
-                        // No elements requested, no bytes needed. data remains nullptr.
-                        // This path shouldn't be hit if _size > current_element_capacity triggered expansion.
-                        return;
-                    }
-                }
-                new_data_ptr = mmap(nullptr, new_capacity_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-                if (new_data_ptr == MAP_FAILED) {
-                    // perror("mmap failed in check_expand (initial allocation)");
-                    throw sjtu::std_bad_alloc(); // Or your project's equivalent
-                }
-            } else { // mremap
-                if (new_capacity_bytes == old_capacity_bytes) return; // No change needed
-                if (new_capacity_bytes == 0) { // Shrinking to zero
-                    munmap(data, old_capacity_bytes); // Unmap the old region
-                    data = nullptr; // data is now null
-                    capacity_bytes = 0; // capacity is zero
-                    // _size should also be 0 if capacity is 0, ensure this invariant elsewhere or here.
-                    return; // Allocation is now zero
-                }
-
-                new_data_ptr = mremap(data, old_capacity_bytes, new_capacity_bytes, MREMAP_MAYMOVE);
-                if (new_data_ptr == MAP_FAILED) {
-                    // perror("mremap failed in check_expand");
-                    // Old mapping (data, old_capacity_bytes) is still valid.
-                    throw sjtu::std_bad_alloc(); // Or your project's equivalent
-                }
+    /**
+     * moves [ind + count, end) down by count slots into the raw slots at ind;
+     * _size is not changed. On a throwing move constructor the not yet moved
+     * elements are dropped, as in shift_up.
+     */
+    void shift_down(size_t ind, size_t count, size_t end) {
+      if constexpr (RELOCATABLE) {
+        memmove(static_cast<void*>(_data + ind), static_cast<void*>(_data + ind + count), (end - ind - count) * SIZE);
+      } else {
+        for (size_t i = ind + count; i < end; ++i) {
+          try {
+            new (_data + i - count) T(std::move(_data[i]));
+          } catch (...) {
+            for (size_t j = i; j < end; ++j) {
+              _data[j].~T();
             }
-            data = static_cast<T*>(new_data_ptr);
-            capacity_bytes = new_capacity_bytes;
+            _size = i - count;
+            throw;
+          }
+          _data[i].~T();
         }
+      }
     }
 
-    /*
-    void check_shrink() { // If you implement this with mremap:
-      size_t current_element_capacity = (capacity_bytes > 0 && SIZE > 0) ? (capacity_bytes / SIZE) : 0;
-      if (_size <= static_cast<size_t>(current_element_capacity * SHRINK_RATE) && current_element_capacity > DEFAULT_SIZE_ELEMENTS) {
-        size_t new_element_capacity = static_cast<size_t>(current_element_capacity * SHRINK_RATE);
-        if (new_element_capacity < _size) new_element_capacity = _size; // Don't shrink below current size
-        if (new_element_capacity < DEFAULT_SIZE_ELEMENTS) new_element_capacity = DEFAULT_SIZE_ELEMENTS; // Don't shrink below default
-        if (new_element_capacity == 0 && _size > 0) new_element_capacity = _size; // Safety for _size > 0
-
-        size_t new_capacity_bytes = new_element_capacity * SIZE;
-        if (new_capacity_bytes < capacity_bytes) { // Only if actually shrinking
-            if (new_capacity_bytes == 0) { // Shrinking to zero elements
-                if (_size == 0) { // Only if vector is empty
-                    munmap(data, capacity_bytes);
-                    data = nullptr;
-                    capacity_bytes = 0;
-                } // else, cannot shrink to 0 bytes if elements exist
-            } else {
-                void* new_data_ptr = mremap(data, capacity_bytes, new_capacity_bytes, MREMAP_MAYMOVE);
-                if (new_data_ptr == MAP_FAILED) {
-                    // perror("mremap shrink failed"); // Non-fatal, just couldn't shrink
-                } else {
-                    data = static_cast<T*>(new_data_ptr);
-                    capacity_bytes = new_capacity_bytes;
-                }
-            }
+    /**
+     * moves the buffer to a block that holds new_element_capacity elements:
+     * allocate for the first block, reallocate afterwards (mremap for the
+     * default allocator), deallocate when shrinking to zero. Trivially
+     * relocatable elements go along with reallocate, others are relocated
+     * into a fresh block. The caller must keep _size <= new_element_capacity.
+     * The allocator may round the size up (huge pages), so capacity() can
+     * end up larger than requested.
+     */
+    void remap(size_t new_element_capacity) {
+      if (new_element_capacity > static_cast<size_t>(-1) / 2 / SIZE) {
+        throw sjtu::std_bad_alloc(); // Byte count would overflow
+      }
+      if (inline_data && new_element_capacity <= inline_capacity) {
+        move_inline();
+        return;
+      }
+      size_t new_capacity_bytes = 0;
+      if (new_element_capacity > 0) {
+        new_capacity_bytes = alloc.good_size(new_element_capacity * SIZE);
+      }
+      if (new_capacity_bytes == capacity_bytes && !is_inline()) return; // No change needed
+
+      if (new_capacity_bytes == 0) { // Shrinking to zero
+        alloc.deallocate(_data, capacity_bytes);
+        reset_storage();
+        return;
+      }
+
+      void* new_data_ptr;
+      if (capacity_bytes > 0 && !is_inline() && RELOCATABLE) {
+        new_data_ptr = alloc.reallocate(_data, capacity_bytes, new_capacity_bytes);
+      } else { // Initial allocation, spill out of the inline buffer or non-relocatable T
+        new_data_ptr = alloc.allocate(new_capacity_bytes);
+        if (new_data_ptr && _data) {
+          try {
+            relocate(static_cast<T*>(new_data_ptr), _data, _size);
+          } catch (...) {
+            alloc.deallocate(new_data_ptr, new_capacity_bytes);
+            throw;
+          }
+          if (!is_inline()) alloc.deallocate(_data, capacity_bytes);
         }
       }
+      if (new_data_ptr == nullptr) {
+        // Old block (_data, capacity_bytes) is still valid.
+        throw sjtu::std_bad_alloc();
+      }
+      retire_iterators(); // Even if mremap grew in place, as std::vector would move
+      _data = static_cast<T*>(new_data_ptr);
+      capacity_bytes = new_capacity_bytes;
+    }
+
+    // Moves the elements back into the inline buffer and drops the block.
+    void move_inline() {
+      if (is_inline()) return;
+      if (_data) {
+        relocate(inline_data, _data, _size);
+        alloc.deallocate(_data, capacity_bytes);
+      }
+      reset_storage();
+    }
+
+    // Grows the buffer by EXPAND_RATE (at least to required elements).
+    void check_expand(size_t required) {
+      size_t current_element_capacity = capacity();
+      if (required > current_element_capacity) {
+        size_t new_element_capacity;
+        if (current_element_capacity == 0) { // Initial allocation
+          new_element_capacity = DEFAULT_SIZE_ELEMENTS;
+        } else {
+          new_element_capacity = static_cast<size_t>(EXPAND_RATE * current_element_capacity);
+        }
+        if (new_element_capacity < required) { // Must be able to hold the requested number of elements
+          new_element_capacity = required;
+        }
+        remap(new_element_capacity);
+      }
+    }
+
+    // Makes sure there is room for one more element at the end.
+    void expand_for_one() {
+      check_expand(_size + 1);
+    }
+
+    // Destroys the elements in [n, _size).
+    void destroy_tail(size_t n) {
+      for (size_t i = n; i < _size; ++i) {
+        _data[i].~T();
+      }
+      _size = n;
+    }
+
+    /**
+     * opens n raw slots at ind (growing at most once and shifting the tail
+     * once) and builds element k in slot ind + k with make(slot, k). If make
+     * throws, the elements built so far are destroyed and the gap is closed.
+     */
+    template<typename Make>
+    void insert_n(size_t ind, size_t n, Make make) {
+      if (n == 0) return;
+      check_expand(_size + n);
+      shift_up(ind, n);
+      size_t k = 0;
+      try {
+        for (; k < n; ++k) {
+          make(_data + ind + k, k);
+        }
+      } catch (...) {
+        for (size_t j = 0; j < k; ++j) {
+          _data[ind + j].~T();
+        }
+        shift_down(ind, n, _size + n);
+        throw;
+      }
+      _size += n;
+    }
+
+    // insert_n for an iterator range. A single-pass range is collected first.
+    template<typename InputIt>
+    void insert_range(size_t ind, InputIt first, InputIt last) {
+      if constexpr (std::forward_iterator<InputIt>) {
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        insert_n(ind, n, [&first](T *slot, size_t) {
+          new (slot) T(*first);
+          ++first;
+        });
+      } else {
+        vector buffer(alloc);
+        for (; first != last; ++first) {
+          buffer.emplace_back(*first);
+        }
+        insert_n(ind, buffer._size, [&buffer](T *slot, size_t k) {
+          new (slot) T(std::move(buffer._data[k]));
+        });
+      }
+    }
+
+    void resize_filled(size_t n, const T &value) {
+      reserve(n);
+      size_t old_size = _size;
+      try {
+        for (; _size < n; ++_size) {
+          new (_data + _size) T(value);
+        }
+      } catch (...) {
+        destroy_tail(old_size);
+        throw;
+      }
+    }
+
+  protected:
+    // For small_vector: an empty vector that starts out in buffer.
+    vector(T *buffer, size_t buffer_elements, const Alloc &alloc)
+        : _data(buffer), capacity_bytes(buffer_elements * SIZE), _size(0), alloc(alloc),
+          inline_capacity(static_cast<unsigned>(buffer_elements)), inline_data(buffer) {}
+
+    void free_resource() {
+      destroy_tail(0);
+      if (!is_inline() && capacity_bytes > 0) {
+        alloc.deallocate(_data, capacity_bytes);
+      }
+      reset_storage();
+    }
+
+    // Copies the elements of other into this empty vector.
+    void copy_from(const vector &other) {
+      if (other._size == 0) return;
+      reserve(other._size);
+      try {
+        for (; _size < other._size; ++_size) {
+          new (_data + _size) T(other._data[_size]);
+        }
+      } catch (...) {
+        free_resource(); // Destroys the copied ones and unmaps
+        throw;
+      }
+    }
+
+    /**
+     * moves the elements of other into this empty vector and leaves other
+     * empty. A block is simply taken over (our allocator must be able to
+     * free it), elements in an inline buffer have to be relocated into our
+     * own storage.
+     */
+    void take(vector &&other) {
+      if (other.is_inline()) {
+        if (other._size > 0) {
+          reserve(other._size);
+          relocate(_data, other._data, other._size);
+          _size = other._size;
+        }
+        other.retire_iterators();
+      } else {
+        _data = other._data;
+        capacity_bytes = other.capacity_bytes;
+        _size = other._size;
+        other.reset_storage();
+      }
+      other._size = 0;
+    }
+
+    vector &move_assign(vector &&other) {
+      if (this == &other) {
+        return *this;
+      }
+      free_resource();
+      alloc = other.alloc; // The block we take belongs to it
+      take(std::move(other));
+      return *this;
     }
-    */
 
   public:
     class const_iterator;
+    /**
+     * a pointer into the buffer. Checked iterators (see SJTU_VECTOR_CHECKED)
+     * also remember their vector and throw on misuse; unchecked ones are
+     * nothing but the pointer, so loops over them vectorize like raw loops.
+     */
     class iterator {
     public:
       using difference_type = std::ptrdiff_t;
@@ -179,71 +404,67 @@ namespace sjtu {
       using pointer = T *;
       using reference = T &;
       using iterator_category = std::random_access_iterator_tag; // Corrected category
+      using iterator_concept = std::contiguous_iterator_tag;
 
     private:
-      int pos = -1; // Stays int, potential mismatch if size_t _size > INT_MAX
-      vector *parent_ptr; // Changed to pointer to allow default construction / uninitialized state
+      T *ptr = nullptr;
+#if SJTU_VECTOR_CHECKED
+      vector *parent_ptr = nullptr;
+#if SJTU_VECTOR_CHECKED >= 2
+      size_t generation = 0;
 
-      iterator(int p, vector *parent) : pos(p), parent_ptr(parent) {} // Constructor takes pointer
+      iterator(T *p, vector *parent) : ptr(p), parent_ptr(parent), generation(parent->generation) {}
+
+      void check_valid() const {
+        if (!parent_ptr || generation != parent_ptr->generation) throw invalid_iterator();
+      }
+#else
+      iterator(T *p, vector *parent) : ptr(p), parent_ptr(parent) {}
+
+      void check_valid() const { if (!parent_ptr) throw invalid_iterator(); }
+#endif
+
+      const vector *owner() const { return parent_ptr; }
+      void check_deref() const {
+        check_valid();
+        if (ptr < parent_ptr->_data || ptr >= parent_ptr->_data + parent_ptr->_size) throw index_out_of_bound();
+      }
+#else
+      iterator(T *p, vector *) : ptr(p) {}
+
+      const vector *owner() const { return nullptr; }
+      void check_valid() const {}
+      void check_deref() const {}
+#endif
 
       friend class vector;
       friend class const_iterator;
 
     public:
-      iterator() : pos(-1), parent_ptr(nullptr) {} // Default constructor
-
-      iterator operator+(const int &n) const {
-        if (!parent_ptr) throw invalid_iterator();
-        iterator new_it(pos + n, parent_ptr);
-        // Boundary checks can be added here or rely on vector's accessors
-        return new_it;
-      }
-      iterator operator-(const int &n) const {
-        if (!parent_ptr) throw invalid_iterator();
-        iterator new_it(pos - n, parent_ptr);
-        return new_it;
-      }
-      int operator-(const iterator &rhs) const {
-        if (parent_ptr != rhs.parent_ptr) throw invalid_iterator();
-        return pos - rhs.pos;
-      }
-      iterator &operator+=(const int &n) {
-        if (!parent_ptr) throw invalid_iterator();
-        pos += n;
-        // It's common for iterators to go one past the end, but not further.
-        // Dereferencing end() is UB.
-        // if (pos > parent_ptr->_size) pos = parent_ptr->_size; // Clamping to end()
-        // if (pos < 0) pos = 0; // Clamping to begin()
-        return *this;
-      }
-      iterator &operator-=(const int &n) {
-        if (!parent_ptr) throw invalid_iterator();
-        pos -= n;
-        return *this;
+      iterator() = default;
+
+      iterator operator+(const difference_type &n) const { iterator temp = *this; return temp += n; }
+      iterator operator-(const difference_type &n) const { iterator temp = *this; return temp -= n; }
+      friend iterator operator+(const difference_type &n, const iterator &it) { return it + n; }
+      difference_type operator-(const iterator &rhs) const {
+        check_valid();
+        rhs.check_valid();
+        if (owner() != rhs.owner()) throw invalid_iterator();
+        return ptr - rhs.ptr;
       }
+      iterator &operator+=(const difference_type &n) { check_valid(); ptr += n; return *this; }
+      iterator &operator-=(const difference_type &n) { check_valid(); ptr -= n; return *this; }
       iterator operator++(int) { iterator temp = *this; ++(*this); return temp; }
-      iterator &operator++() { if (!parent_ptr) throw invalid_iterator(); ++pos; return *this; }
+      iterator &operator++() { check_valid(); ++ptr; return *this; }
       iterator operator--(int) { iterator temp = *this; --(*this); return temp; }
-      iterator &operator--() { if (!parent_ptr) throw invalid_iterator(); --pos; return *this; }
-      T &operator*() const {
-        if (!parent_ptr) throw invalid_iterator();
-        if (pos < 0 || static_cast<size_t>(pos) >= parent_ptr->_size) throw index_out_of_bound(); // Or invalid_iterator
-        return parent_ptr->data[pos];
-      }
-       pointer operator->() const {
-        if (!parent_ptr) throw invalid_iterator();
-        if (pos < 0 || static_cast<size_t>(pos) >= parent_ptr->_size) throw index_out_of_bound();
-        return &(parent_ptr->data[pos]);
-      }
-      bool operator==(const iterator &rhs) const { return parent_ptr == rhs.parent_ptr && pos == rhs.pos; }
+      iterator &operator--() { check_valid(); --ptr; return *this; }
+      T &operator*() const { check_deref(); return *ptr; }
+      // No bounds check, std::to_address(end()) has to work
+      pointer operator->() const { check_valid(); return ptr; }
+      T &operator[](const difference_type &n) const { return *(*this + n); }
+      bool operator==(const iterator &rhs) const { return ptr == rhs.ptr && owner() == rhs.owner(); }
       bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
-      // Comparison with const_iterator
-      bool operator==(const const_iterator &rhs) const {
-        return parent_ptr == rhs.parent_ptr && pos == rhs.pos;
-      };
-      bool operator!=(const const_iterator &rhs) const {
-        return !(*this == rhs);
-      };
+      auto operator<=>(const iterator &rhs) const { return ptr <=> rhs.ptr; }
     };
 
     class const_iterator {
@@ -253,90 +474,131 @@ namespace sjtu {
       using pointer = const T *; // const T*
       using reference = const T &; // const T&
       using iterator_category = std::random_access_iterator_tag; // Corrected category
+      using iterator_concept = std::contiguous_iterator_tag;
 
     private:
-      int pos = -1;
-      const vector *parent_ptr; // Changed to pointer
+      const T *ptr = nullptr;
+#if SJTU_VECTOR_CHECKED
+      const vector *parent_ptr = nullptr;
+#if SJTU_VECTOR_CHECKED >= 2
+      size_t generation = 0;
+
+      const_iterator(const T *p, const vector *parent) : ptr(p), parent_ptr(parent), generation(parent->generation) {}
+
+      void check_valid() const {
+        if (!parent_ptr || generation != parent_ptr->generation) throw invalid_iterator();
+      }
+#else
+      const_iterator(const T *p, const vector *parent) : ptr(p), parent_ptr(parent) {}
+
+      void check_valid() const { if (!parent_ptr) throw invalid_iterator(); }
+#endif
+
+      const vector *owner() const { return parent_ptr; }
+      void check_deref() const {
+        check_valid();
+        if (ptr < parent_ptr->_data || ptr >= parent_ptr->_data + parent_ptr->_size) throw index_out_of_bound();
+      }
+#else
+      const_iterator(const T *p, const vector *) : ptr(p) {}
 
-      const_iterator(int p, const vector *parent) : pos(p), parent_ptr(parent) {}
+      const vector *owner() const { return nullptr; }
+      void check_valid() const {}
+      void check_deref() const {}
+#endif
 
       friend class vector;
       friend class iterator;
 
     public:
-      const_iterator() : pos(-1), parent_ptr(nullptr) {} // Default constructor
-
-      const_iterator operator+(const int &n) const {
-        if (!parent_ptr) throw invalid_iterator();
-        const_iterator new_it(pos + n, parent_ptr);
-        return new_it;
+      const_iterator() = default;
+      // Keeps the generation of other, a stale iterator stays stale
+      const_iterator(const iterator &other) {
+        ptr = other.ptr;
+#if SJTU_VECTOR_CHECKED
+        parent_ptr = other.parent_ptr;
+#if SJTU_VECTOR_CHECKED >= 2
+        generation = other.generation;
+#endif
+#endif
       }
-      const_iterator operator-(const int &n) const {
-        if (!parent_ptr) throw invalid_iterator();
-        const_iterator new_it(pos - n, parent_ptr);
-        return new_it;
-      }
-      int operator-(const const_iterator &rhs) const {
-        if (parent_ptr != rhs.parent_ptr) throw invalid_iterator();
-        return pos - rhs.pos;
+
+      const_iterator operator+(const difference_type &n) const { const_iterator temp = *this; return temp += n; }
+      const_iterator operator-(const difference_type &n) const { const_iterator temp = *this; return temp -= n; }
+      friend const_iterator operator+(const difference_type &n, const const_iterator &it) { return it + n; }
+      difference_type operator-(const const_iterator &rhs) const {
+        check_valid();
+        rhs.check_valid();
+        if (owner() != rhs.owner()) throw invalid_iterator();
+        return ptr - rhs.ptr;
       }
-      const_iterator &operator+=(const int &n) { if (!parent_ptr) throw invalid_iterator(); pos += n; return *this; }
-      const_iterator &operator-=(const int &n) { if (!parent_ptr) throw invalid_iterator(); pos -= n; return *this; }
+      const_iterator &operator+=(const difference_type &n) { check_valid(); ptr += n; return *this; }
+      const_iterator &operator-=(const difference_type &n) { check_valid(); ptr -= n; return *this; }
       const_iterator operator++(int) { const_iterator temp = *this; ++(*this); return temp; }
-      const_iterator &operator++() { if (!parent_ptr) throw invalid_iterator(); ++pos; return *this; }
+      const_iterator &operator++() { check_valid(); ++ptr; return *this; }
       const_iterator operator--(int) { const_iterator temp = *this; --(*this); return temp; }
-      const_iterator &operator--() { if (!parent_ptr) throw invalid_iterator(); --pos; return *this; }
-      const T &operator*() const {
-        if (!parent_ptr) throw invalid_iterator();
-        if (pos < 0 || static_cast<size_t>(pos) >= parent_ptr->_size) throw index_out_of_bound();
-        return parent_ptr->data[pos];
-      }
-      pointer operator->() const {
-        if (!parent_ptr) throw invalid_iterator();
-        if (pos < 0 || static_cast<size_t>(pos) >= parent_ptr->_size) throw index_out_of_bound();
-        return &(parent_ptr->data[pos]);
-      }
-      bool operator==(const const_iterator &rhs) const { return parent_ptr == rhs.parent_ptr && pos == rhs.pos; }
+      const_iterator &operator--() { check_valid(); --ptr; return *this; }
+      const T &operator*() const { check_deref(); return *ptr; }
+      // No bounds check, std::to_address(end()) has to work
+      pointer operator->() const { check_valid(); return ptr; }
+      const T &operator[](const difference_type &n) const { return *(*this + n); }
+      // Comparison with iterator goes through the converting constructor
+      bool operator==(const const_iterator &rhs) const { return ptr == rhs.ptr && owner() == rhs.owner(); }
       bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
-      // Comparison with iterator
-      bool operator==(const iterator &rhs) const {
-        return parent_ptr == rhs.parent_ptr && pos == rhs.pos;
-      };
-      bool operator!=(const iterator &rhs) const{
-        return !(*this == rhs);
-      };
+      auto operator<=>(const const_iterator &rhs) const { return ptr <=> rhs.ptr; }
     };
 
+  private:
+    // Index of it in this vector; a checked iterator has to belong to us.
+    size_t index_of(const const_iterator &it) const {
+#if SJTU_VECTOR_CHECKED
+      if (it.parent_ptr != this) throw invalid_iterator();
+#if SJTU_VECTOR_CHECKED >= 2
+      if (it.generation != generation) throw invalid_iterator();
+#endif
+#endif
+      return static_cast<size_t>(it.ptr - _data);
+    }
 
+  public:
+    vector() : vector(Alloc()) {}
+
+    /**
+     * an empty vector that gets its memory from alloc, e.g.
+     *   monotonic_arena arena(buffer, sizeof(buffer));
+     *   vector<int, arena_allocator> v{arena_allocator(arena)};
+     * The allocator is kept by copies and moves.
+     */
+    explicit vector(const Alloc &alloc)
+        : _data(nullptr), capacity_bytes(0), _size(0), alloc(alloc),
+          inline_capacity(0), inline_data(nullptr) {}
+
+    /**
+     * an empty vector whose mappings follow policy, e.g.
+     *   vector<long long> v(map_policy::huge_pages | map_policy::populate);
+     */
+    explicit vector(map_policy policy)
+      requires std::is_constructible_v<Alloc, map_policy>
+        : vector(Alloc(policy)) {}
+
+    vector(const vector &other) : vector(other.alloc) {
+      copy_from(other);
+    }
 
+    /**
+     * takes over the block of other, no element is touched.
+     * A small_vector that still uses its inline buffer goes to the overload
+     * below; moved through a plain vector& it still works, but then a
+     * failed allocation ends the program.
+     */
+    vector(vector &&other) noexcept : vector(other.alloc) {
+      take(std::move(other));
+    }
 
-    vector() : data(nullptr), capacity_bytes(0), _size(0) {}
-
-    vector(const vector &other) : data(nullptr), capacity_bytes(0), _size(0) {
-      if (other.capacity_bytes > 0) {
-        void* new_mem = mmap(nullptr, other.capacity_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-        if (new_mem == MAP_FAILED) {
-          throw sjtu::std_bad_alloc();
-        }
-        data = static_cast<T*>(new_mem);
-        capacity_bytes = other.capacity_bytes;
-        _size = other._size;
-        try {
-          for (size_t i = 0; i < _size; ++i) {
-            new (data + i) T(other.data[i]);
-          }
-        } catch (...) {
-          munmap(data, capacity_bytes); // Clean up allocated memory on exception during copy
-          data = nullptr;
-          capacity_bytes = 0;
-          _size = 0;
-          throw; // Re-throw the exception
-        }
-      } else {
-        // other is empty and unallocated, so this vector is also empty and unallocated
-        _size = other._size; // Should be 0
-        // data, capacity_bytes already 0
-      }
+    // The elements of an inline buffer need a block of their own, so this may throw.
+    template<size_t N>
+    vector(small_vector<T, N, Alloc> &&other) : vector(other.alloc) {
+      take(std::move(other));
     }
 
     ~vector() {
@@ -347,172 +609,340 @@ namespace sjtu {
       if (this == &other) {
         return *this;
       }
+      // Copy into a temporary first for the strong exception guarantee,
+      // our own allocator stays.
+      vector tmp(alloc);
+      tmp.copy_from(other);
+      return *this = std::move(tmp);
+    }
 
-      // Temporary vector for strong exception guarantee (copy-and-swap idiom)
-      // Or, allocate new, copy, then free old.
-      // For mmap, direct re-allocation might be simpler if we ensure cleanup on failure.
-
-      T* new_data_temp = nullptr;
-      size_t new_capacity_bytes_temp = 0;
-
-      if (other.capacity_bytes > 0) {
-        void* new_mem = mmap(nullptr, other.capacity_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-        if (new_mem == MAP_FAILED) {
-          throw sjtu::std_bad_alloc();
-        }
-        new_data_temp = static_cast<T*>(new_mem);
-        new_capacity_bytes_temp = other.capacity_bytes;
-
-        size_t copied_count = 0;
-        try {
-          for (size_t i = 0; i < other._size; ++i) {
-            new (new_data_temp + i) T(other.data[i]);
-            copied_count++;
-          }
-        } catch (...) {
-          // Destruct successfully copied elements
-          for (size_t i = 0; i < copied_count; ++i) {
-            (new_data_temp + i)->~T();
-          }
-          munmap(new_data_temp, new_capacity_bytes_temp);
-          throw; // Re-throw
-        }
-      }
-
-      // Successfully allocated and copied to temporary. Now destroy old state and assign new.
-      free_resource(); // Destroy and unmap current data
-
-      data = new_data_temp;
-      capacity_bytes = new_capacity_bytes_temp;
-      _size = other._size;
+    // Drops our own elements and block, then steals the block of other.
+    vector &operator=(vector &&other) noexcept {
+      return move_assign(std::move(other));
+    }
 
-      return *this;
+    template<size_t N>
+    vector &operator=(small_vector<T, N, Alloc> &&other) {
+      return move_assign(std::move(other));
     }
 
     T &at(const size_t &pos) {
       if (pos >= _size) throw index_out_of_bound();
-      return data[pos];
+      return _data[pos];
     }
     const T &at(const size_t &pos) const {
       if (pos >= _size) throw index_out_of_bound();
-      return data[pos];
+      return _data[pos];
     }
     T &operator[](const size_t &pos) {
       if (pos >= _size) throw index_out_of_bound(); // As per your requirement
-      return data[pos];
+      return _data[pos];
     }
     const T &operator[](const size_t &pos) const {
       if (pos >= _size) throw index_out_of_bound(); // As per your requirement
-      return data[pos];
+      return _data[pos];
     }
 
-    const T &front() const { if (empty()) throw container_is_empty(); return data[0]; }
-    const T &back() const { if (empty()) throw container_is_empty(); return data[_size - 1]; }
+    const T &front() const { if (empty()) throw container_is_empty(); return _data[0]; }
+    const T &back() const { if (empty()) throw container_is_empty(); return _data[_size - 1]; }
+
+    // The buffer itself, nullptr for a vector that never allocated.
+    T *data() { return _data; }
+    const T *data() const { return _data; }
 
-    iterator begin() { return iterator(0, this); }
-    const_iterator begin() const { return const_iterator(0, this); }
-    const_iterator cbegin() const { return const_iterator(0, this); }
-    iterator end() { return iterator(static_cast<int>(_size), this); } // Cast _size to int for iterator
-    const_iterator end() const { return const_iterator(static_cast<int>(_size), this); }
-    const_iterator cend() const { return const_iterator(static_cast<int>(_size), this); }
+    iterator begin() { return iterator(_data, this); }
+    const_iterator begin() const { return const_iterator(_data, this); }
+    const_iterator cbegin() const { return const_iterator(_data, this); }
+    iterator end() { return iterator(_data + _size, this); }
+    const_iterator end() const { return const_iterator(_data + _size, this); }
+    const_iterator cend() const { return const_iterator(_data + _size, this); }
 
     bool empty() const { return _size == 0; }
     size_t size() const { return _size; }
     // Add capacity() method for users, returning element count
+    Alloc get_allocator() const { return alloc; }
     size_t capacity() const { return (capacity_bytes > 0 && SIZE > 0) ? (capacity_bytes / SIZE) : 0; }
 
 
-    void clear() {
-      for (size_t i = 0; i < _size; ++i) {
-        data[i].~T();
+    /**
+     * makes room for at least n elements with a single (re)allocation,
+     * so a following run of push_back never has to grow.
+     */
+    void reserve(size_t n) {
+      if (n > capacity()) {
+        remap(n);
       }
-      _size = 0;
-      // Note: clear usually does not deallocate memory. If you want to deallocate,
-      // you might add a shrink_to_fit() method or modify clear().
+    }
+
+    /**
+     * gives the unused tail of the mapping back to the kernel.
+     * An empty vector drops its mapping completely.
+     */
+    void shrink_to_fit() {
+      remap(_size);
+    }
+
+    /**
+     * changes the number of elements to n. New elements are
+     * value-initialized (or copies of value), extra ones are destroyed.
+     */
+    void resize(size_t n) {
+      if (n <= _size) {
+        destroy_tail(n);
+        return;
+      }
+      reserve(n);
+      size_t old_size = _size;
+      try {
+        for (; _size < n; ++_size) {
+          new (_data + _size) T();
+        }
+      } catch (...) {
+        destroy_tail(old_size);
+        throw;
+      }
+    }
+
+    void resize(size_t n, const T &value) {
+      if (n <= _size) {
+        destroy_tail(n);
+        return;
+      }
+      if (n > capacity()) {
+        T copy(value); // value may live in the mapping that is about to move
+        resize_filled(n, copy);
+      } else {
+        resize_filled(n, value);
+      }
+    }
+
+    void clear() {
+      destroy_tail(0);
+      // Note: clear does not deallocate memory, use shrink_to_fit() for that.
     }
 
     iterator insert(iterator it_pos, const T &value) {
-      if (it_pos.parent_ptr != this) throw invalid_iterator();
-      return insert(static_cast<size_t>(it_pos.pos), value);
+      return emplace(index_of(it_pos), value);
+    }
+
+    iterator insert(iterator it_pos, T &&value) {
+      return emplace(index_of(it_pos), std::move(value));
     }
 
     iterator insert(const size_t &ind, const T &value) {
-      if (ind > _size) throw index_out_of_bound();
+      return emplace(ind, value);
+    }
 
-      // If _size will reach capacity, check_expand needs to be called *before* memmove
-      // Original logic: _size += 1; check_expand();
-      // This means check_expand sees the *new* size.
-      // Let's consider the case where data is nullptr (empty vector)
+    iterator insert(const size_t &ind, T &&value) {
+      return emplace(ind, std::move(value));
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator it_pos, Args &&...args) {
+      return emplace(index_of(it_pos), std::forward<Args>(args)...);
+    }
 
-      if (_size == ((capacity_bytes > 0 && SIZE > 0) ? (capacity_bytes / SIZE) : 0) ) { // If we are at full capacity
-          // Temporarily increment _size to correctly calculate new capacity in check_expand
-          _size++;
-          check_expand();
-          _size--; // Revert _size, as it will be incremented properly later
-      } else if (data == nullptr && _size == 0) { // Special case: inserting into totally empty vector
-          _size++; // Target size is 1
-          check_expand(); // This will perform initial mmap
-          _size--; // Revert
+    /**
+     * constructs a new element in front of ind.
+     * The element is built before anything is moved, so args may refer to
+     * elements of this vector (check_expand() can move the whole mapping).
+     */
+    template<typename... Args>
+    iterator emplace(const size_t &ind, Args &&...args) {
+      if (ind > _size) throw index_out_of_bound();
+      if (ind == _size) {
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(_data + ind, this);
       }
 
+      T value(std::forward<Args>(args)...);
+      expand_for_one();
 
-      // Shift elements
-      if (ind < _size) { // Only move if not inserting at the very end
-        // Use T* for pointer arithmetic with memmove if SIZE is used for byte count
-        memmove(data + ind + 1, data + ind, (_size - ind) * SIZE);
+      shift_up(ind, 1);
+      try {
+        new (_data + ind) T(std::move(value));
+      } catch (...) {
+        shift_down(ind, 1, _size + 1); // Close the gap again
+        throw;
       }
-
-      new (data + ind) T(value);
       _size++;
-      return iterator(static_cast<int>(ind), this);
+      return iterator(_data + ind, this);
+    }
+
+    /**
+     * inserts count copies of value in front of it_pos.
+     * The tail is shifted once, no matter how large count is.
+     */
+    iterator insert(iterator it_pos, size_t count, const T &value) {
+      size_t ind = index_of(it_pos);
+      if (ind > _size) throw index_out_of_bound();
+      T copy(value); // value may be one of ours and move with the tail
+      insert_n(ind, count, [&copy](T *slot, size_t) {
+        new (slot) T(copy);
+      });
+      return iterator(_data + ind, this);
+    }
+
+    /**
+     * inserts copies of [first, last) in front of it_pos, growing at most
+     * once and shifting the tail once. The range must not point into this
+     * vector.
+     */
+    template<typename InputIt>
+      requires (!std::is_integral_v<InputIt>)
+    iterator insert(iterator it_pos, InputIt first, InputIt last) {
+      size_t ind = index_of(it_pos);
+      if (ind > _size) throw index_out_of_bound();
+      insert_range(ind, first, last);
+      return iterator(_data + ind, this);
+    }
+
+    /**
+     * replaces the contents with count copies of value.
+     */
+    void assign(size_t count, const T &value) {
+      T copy(value);
+      clear();
+      insert_n(0, count, [&copy](T *slot, size_t) {
+        new (slot) T(copy);
+      });
+    }
+
+    /**
+     * replaces the contents with copies of [first, last), which must not
+     * point into this vector.
+     */
+    template<typename InputIt>
+      requires (!std::is_integral_v<InputIt>)
+    void assign(InputIt first, InputIt last) {
+      clear();
+      insert_range(0, first, last);
+    }
+
+    /**
+     * erases [first, last) and shifts the tail down once.
+     * return an iterator to the element that followed last.
+     */
+    iterator erase(iterator first, iterator last) {
+      size_t ind = index_of(first);
+      size_t end = index_of(last);
+      if (ind > end || end > _size) throw index_out_of_bound();
+      size_t count = end - ind;
+      for (size_t i = ind; i < ind + count; ++i) {
+        _data[i].~T();
+      }
+      shift_down(ind, count, _size);
+      _size -= count;
+      return iterator(_data + ind, this);
     }
 
     iterator erase(iterator it_pos) {
-      if (it_pos.parent_ptr != this) throw invalid_iterator();
-      return erase(static_cast<size_t>(it_pos.pos));
+      return erase(index_of(it_pos));
     }
 
     iterator erase(const size_t &ind) {
       if (ind >= _size) throw index_out_of_bound();
 
-      data[ind].~T();
-      if (ind < _size - 1) { // Only move if not erasing the last element
-        memmove(data + ind, data + ind + 1, (_size - 1 - ind) * SIZE);
-      }
+      _data[ind].~T();
+      shift_down(ind, 1, _size);
       _size--;
-      // check_shrink(); // Optional
-      return iterator(static_cast<int>(ind), this);
+      return iterator(_data + ind, this);
     }
 
     void push_back(const T &value) {
-      // If _size will reach capacity, check_expand needs to be called
-      if (_size == ((capacity_bytes > 0 && SIZE > 0) ? (capacity_bytes / SIZE) : 0) ) {
-          // Temporarily increment _size for check_expand's logic
-          _size++;
-          check_expand();
-          _size--; // Revert, actual increment is next
-      } else if (data == nullptr && _size == 0) { // Special case: totally empty vector
-          _size++;
-          check_expand();
-          _size--;
-      }
-
-      new (data + _size) T(value);
-      _size++;
+      emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+      emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    T &emplace_back(Args &&...args) {
+      if (_size < capacity()) {
+        new (_data + _size) T(std::forward<Args>(args)...);
+      } else {
+        // args may live in our own buffer, build it before the mapping moves
+        T value(std::forward<Args>(args)...);
+        expand_for_one();
+        new (_data + _size) T(std::move(value));
+      }
+      return _data[_size++];
     }
 
     void pop_back() {
       if (empty()) throw container_is_empty();
       _size--;
-      data[_size].~T();
-      // check_shrink(); // Optional
+      _data[_size].~T();
     }
   };
 
-  // ... (rest of the vector class definition above) ...
+  /**
+   * a vector that keeps up to N elements in a buffer inside the object, so
+   * small instances never touch the allocator. Once it grows past N the
+   * elements move to a block from Alloc; shrink_to_fit() or clear() followed
+   * by shrink_to_fit() brings them back if they fit again.
+   * It is a vector<T, Alloc>, so it can be passed wherever a vector& is expected.
+   */
+  template<typename T, size_t N, class Alloc>
+  class small_vector : public vector<T, Alloc> {
+    static_assert(N > 0, "use sjtu::vector for an empty inline buffer");
+    static_assert(N <= static_cast<unsigned>(-1), "inline buffer too large");
+
+    using base = vector<T, Alloc>;
+
+    alignas(T) unsigned char buffer[N * sizeof(T)];
+
+    T *inline_buffer() {
+      return reinterpret_cast<T *>(buffer);
+    }
+
+  public:
+    using base::operator=;
+
+    small_vector() : small_vector(Alloc()) {}
+
+    explicit small_vector(const Alloc &alloc) : base(inline_buffer(), N, alloc) {}
+
+    explicit small_vector(map_policy policy)
+      requires std::is_constructible_v<Alloc, map_policy>
+        : small_vector(Alloc(policy)) {}
+
+    small_vector(const small_vector &other) : small_vector(other.get_allocator()) {
+      this->copy_from(other);
+    }
+
+    small_vector(const base &other) : small_vector(other.get_allocator()) {
+      this->copy_from(other);
+    }
 
-}; // End of class vector<T>
+    small_vector(small_vector &&other) : small_vector(other.get_allocator()) {
+      this->take(std::move(other));
+    }
+
+    small_vector(base &&other) : small_vector(other.get_allocator()) {
+      this->take(std::move(other));
+    }
+
+    ~small_vector() {
+      this->free_resource(); // While buffer is still alive
+    }
+
+    small_vector &operator=(const small_vector &other) {
+      if (this != &other) {
+        small_vector tmp(this->get_allocator()); // Our own allocator stays, as in vector
+        tmp.copy_from(other);
+        base::operator=(std::move(tmp));
+      }
+      return *this;
+    }
+
+    small_vector &operator=(small_vector &&other) {
+      base::operator=(std::move(other));
+      return *this;
+    }
+  };
 
-// --- Implementations for iterator and const_iterator cross-comparison ---
+}  // namespace sjtu
 
 #endif // SJTU_VECTOR_HPP
\ No newline at end of file